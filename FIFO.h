@@ -1,7 +1,6 @@
 #ifndef FIFO_H
 #define FIFO_H
 
-#include <iostream>
 #include <cstring>
 #include <stdexcept>
 #include <vector>
@@ -97,7 +96,6 @@ public:
             }
             else      // 数据结束索引超出结尾 循环到开始
             {
-                std::cout << "缓存重新开始...." << std::endl;
                 int overflowIndexLength = (DataEnd + count) - static_cast<int>(Buffer.size());   // 超出索引长度
                 int endPushIndexLength = count - overflowIndexLength;       // 填充在末尾的数据长度
 
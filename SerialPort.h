@@ -13,6 +13,11 @@
 #include <memory>
 #include <chrono>
 #include <queue>
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 // void print_data(const uint8_t* data, uint8_t len)
 // {
@@ -28,6 +33,21 @@ class SerialPort
 public:
   using SharedPtr = std::shared_ptr<SerialPort>;
 
+  /**
+   * @brief 接收方式
+   *
+   * Select：select等待至多timeout再read (默认，空闲时不占CPU)；
+   * BusyPoll：非阻塞read自旋直到有数据或超时，延迟最低但占满一个核，可选pause退避；
+   * Blocking：poll无超时等待串口与唤醒eventfd，VMIN设为一帧字节数、VTIME为字节间隔，凑满一帧才返回，
+   *           不再按timeout周期性醒来；停止时用interrupt_reader()唤醒。
+   */
+  enum class RxMode
+  {
+    Select,
+    BusyPoll,
+    Blocking
+  };
+
   SerialPort(std::string port, speed_t baudrate, int timeout_ms = 2)
   {
     set_timeout(timeout_ms);
@@ -37,6 +57,10 @@ public:
   ~SerialPort()
   {
     close(fd_);
+    if (wake_fd_ >= 0)
+    {
+      close(wake_fd_);
+    }
   }
 
   ssize_t send(const uint8_t* data, size_t len)
@@ -46,14 +70,26 @@ public:
     // tcdrain(fd_);
     return ret;
   }
-//最多读取 len 字节 ,放入 data
+//最多读取 len 字节 ,放入 data；超时或被interrupt_reader打断时返回0
   ssize_t recv(uint8_t* data, size_t len)
   {
+    switch (rx_mode_)
+    {
+    case RxMode::BusyPoll:
+      return recv_busy_poll(data, len);
+    case RxMode::Blocking:
+      return recv_blocking(data, len);
+    case RxMode::Select:
+      break;
+    }
+
     FD_ZERO(&rSet_);
     FD_SET(fd_, &rSet_);
     ssize_t recv_len = 0;
+    // Linux的select会把剩余时间写回timeval，传副本，否则超时一次后就变成零超时的空转
+    timeval timeout = timeout_;
 
-    switch (select(fd_ + 1, &rSet_, NULL, NULL, &timeout_))
+    switch (select(fd_ + 1, &rSet_, NULL, NULL, &timeout))
     {
     case -1: // error
       std::cout << "communication error" << std::endl;
@@ -99,6 +135,52 @@ public:
     }
   }
 
+  int fd() const
+  {
+    return fd_;
+  }
+
+  /**
+   * @brief 切换接收方式
+   * @param backoff BusyPoll时连续读空后逐渐拉长pause次数，降低对超线程兄弟核和总线的干扰
+   * @param frame_bytes Blocking时的VMIN (一帧字节数)
+   * @param inter_byte_ds Blocking时的VTIME (字节间隔超时，0.1秒为单位，至少为1：
+   *        VTIME=0时poll之后的read要凑满VMIN才返回，eventfd无法唤醒它)
+   */
+  void set_rx_mode(RxMode mode, bool backoff = true, int frame_bytes = 16, int inter_byte_ds = 1)
+  {
+    rx_mode_ = mode;
+    busy_backoff_ = backoff;
+
+    const int flags = fcntl(fd_, F_GETFL);
+    fcntl(fd_, F_SETFL, mode == RxMode::BusyPoll ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+
+    struct termios option;
+    if (tcgetattr(fd_, &option) == 0)
+    {
+      const bool blocking = mode == RxMode::Blocking;
+      option.c_cc[VMIN] = blocking ? static_cast<cc_t>(std::clamp(frame_bytes, 1, 255)) : 0;
+      option.c_cc[VTIME] = blocking ? static_cast<cc_t>(std::clamp(inter_byte_ds, 1, 255)) : 0;
+      tcsetattr(fd_, TCSANOW, &option);
+    }
+  }
+
+  RxMode rx_mode() const
+  {
+    return rx_mode_;
+  }
+
+  /**
+   * @brief 唤醒阻塞在recv中的线程 (Blocking模式下停止接收线程时调用，线程安全)
+   *
+   * 写唤醒eventfd，recv从poll返回0；调用时接收线程不在recv中则下一次recv立即返回0。
+   */
+  void interrupt_reader()
+  {
+    const uint64_t one = 1;
+    (void)::write(wake_fd_, &one, sizeof(one));
+  }
+
   void set_timeout(int timeout_ms)
   {
     timeout_.tv_sec = timeout_ms / 1000;
@@ -106,6 +188,73 @@ public:
   }
 
 private:
+  ssize_t recv_busy_poll(uint8_t* data, size_t len)
+  {
+    constexpr unsigned kMaxPause = 64;
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::seconds(timeout_.tv_sec) + std::chrono::microseconds(timeout_.tv_usec);
+    unsigned pause = 1;
+    while (true)
+    {
+      const ssize_t recv_len = ::read(fd_, data, len);
+      if (recv_len > 0)
+      {
+        return recv_len;
+      }
+      if (recv_len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+        return -1;
+      }
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        return 0;
+      }
+      if (busy_backoff_)
+      {
+        for (unsigned i = 0; i < pause; ++i)
+        {
+          cpu_relax();
+        }
+        pause = std::min(pause * 2, kMaxPause);
+      }
+    }
+  }
+
+  // 只在poll报告可读后才read：VTIME>0时首字节到达即可读，read至多再等一个字节间隔
+  ssize_t recv_blocking(uint8_t* data, size_t len)
+  {
+    pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0)
+    {
+      return errno == EINTR ? 0 : -1;
+    }
+    if (fds[1].revents & POLLIN)
+    {
+      uint64_t count;
+      (void)::read(wake_fd_, &count, sizeof(count));
+      return 0;
+    }
+    if ((fds[0].revents & (POLLIN | POLLERR | POLLHUP)) == 0)
+    {
+      return 0;
+    }
+    const ssize_t recv_len = ::read(fd_, data, len);
+    if (recv_len < 0 && errno == EINTR)
+    {
+      return 0;
+    }
+    return recv_len;
+  }
+
+  static void cpu_relax()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+  }
+
   void Init(std::string port, speed_t baudrate)
   {
     int ret;
@@ -118,6 +267,7 @@ private:
         printf("error: %s\n", strerror(errno));
       exit(-1);
     }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
     // Set attributes
     struct termios option;
@@ -146,9 +296,13 @@ private:
   }
 
   int fd_;
+  int wake_fd_ = -1;  // Blocking接收的唤醒eventfd
 	fd_set rSet_;
   timeval timeout_;
 
+  RxMode rx_mode_ = RxMode::Select;
+  bool busy_backoff_ = true;
+
   std::queue<uint8_t> recv_queue;
   std::array<uint8_t, 1024> recv_buf;
 };
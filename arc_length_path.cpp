@@ -0,0 +1,124 @@
+#include "arc_length_path.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kSubdivision = 4;  // 累计弧长表相对索引的细分倍数
+
+} // namespace
+
+bool ArcLengthPath::build(Curve curve, float u0, float u1, int resolution)
+{
+    curve_ = std::move(curve);
+    uAtS_.clear();
+    length_ = 0.0f;
+    if (!curve_ || resolution < 1 || !(u1 > u0)) {
+        return false;
+    }
+
+    // 1. 参数均匀细分的累计弧长 (弦长和，双精度累加)
+    const int fine = resolution * kSubdivision;
+    const double du = (static_cast<double>(u1) - u0) / fine;
+    std::vector<double> cumulative(fine + 1, 0.0);
+    Vector3f previous = curve_(u0);
+    for (int k = 1; k <= fine; ++k) {
+        const Vector3f p = curve_(static_cast<float>(u0 + k * du));
+        cumulative[k] = cumulative[k - 1] + (p - previous).norm();
+        previous = p;
+    }
+    const double total = cumulative.back();
+    if (!(total > 1e-9)) {
+        return false;
+    }
+
+    // 2. 按弧长均匀重采样：单调扫描一次得到 s -> u 索引
+    uAtS_.resize(resolution + 1);
+    int k = 0;
+    for (int i = 0; i <= resolution; ++i) {
+        const double s = total * i / resolution;
+        while (k + 1 < fine && cumulative[k + 1] < s) {
+            ++k;
+        }
+        const double span = cumulative[k + 1] - cumulative[k];
+        const double r = span > 0.0 ? std::clamp((s - cumulative[k]) / span, 0.0, 1.0) : 0.0;
+        uAtS_[i] = static_cast<float>(u0 + (k + r) * du);
+    }
+    uAtS_.front() = u0;
+    uAtS_.back() = u1;
+
+    length_ = static_cast<float>(total);
+    step_ = length_ / resolution;
+    invStep_ = resolution / length_;
+    return true;
+}
+
+float ArcLengthPath::parameterAt(float s) const
+{
+    const float x = std::clamp(s, 0.0f, length_) * invStep_;
+    const size_t i = std::min(static_cast<size_t>(x), uAtS_.size() - 2);
+    const float r = x - static_cast<float>(i);
+    return uAtS_[i] + r * (uAtS_[i + 1] - uAtS_[i]);
+}
+
+Vector3f ArcLengthPath::position(float s) const
+{
+    return curve_(parameterAt(s));
+}
+
+TrajectoryPoint ArcLengthPath::evaluate(float s, float speed, float accel) const
+{
+    TrajectoryPoint point;
+    if (empty()) {
+        return point;
+    }
+
+    // 单位速度参数化：一阶差分为切向，二阶差分为曲率向量
+    const float center = std::clamp(s, step_, length_ - step_);
+    const Vector3f before = position(center - step_);
+    const Vector3f middle = position(center);
+    const Vector3f after = position(center + step_);
+    const Vector3f tangent = (after - before) / (2.0f * step_);
+    const Vector3f curvature = (after - 2.0f * middle + before) / (step_ * step_);
+
+    point.position = position(s);
+    point.velocity = tangent * speed;
+    point.acceleration = tangent * accel + curvature * (speed * speed);
+    return point;
+}
+
+ArcLengthPath::Curve ArcLengthPath::line(const Vector3f& a, const Vector3f& b)
+{
+    return [a, b](float u) -> Vector3f { return a + u * (b - a); };
+}
+
+ArcLengthPath::Curve ArcLengthPath::circle(const Vector3f& center, float radius)
+{
+    return [center, radius](float u) -> Vector3f {
+        return center + Vector3f(radius * std::cos(u), radius * std::sin(u), 0.0f);
+    };
+}
+
+ArcLengthPath::Curve ArcLengthPath::figureEight(const Vector3f& center, float size)
+{
+    return [center, size](float u) -> Vector3f {
+        return center + Vector3f(size * std::sin(u), size * std::sin(u) * std::cos(u), 0.0f);
+    };
+}
+
+ArcLengthPath::Curve ArcLengthPath::spiral(const Vector3f& center, float radius, float turns)
+{
+    const float sweep = 2.0f * static_cast<float>(M_PI) * turns;
+    return [center, radius, sweep](float u) -> Vector3f {
+        const float r = radius * u;
+        return center + Vector3f(r * std::cos(sweep * u), r * std::sin(sweep * u), 0.0f);
+    };
+}
+
+ArcLengthPath::Curve ArcLengthPath::helix(const Vector3f& center, float radius, float risePerRadian)
+{
+    return [center, radius, risePerRadian](float u) -> Vector3f {
+        return center + Vector3f(radius * std::cos(u), radius * std::sin(u), risePerRadian * u);
+    };
+}
@@ -0,0 +1,73 @@
+#ifndef ARC_LENGTH_PATH_H
+#define ARC_LENGTH_PATH_H
+
+#include "robot_common.h"
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 按弧长参数化的笛卡尔路径
+ *
+ * 构建时对曲线参数u做一次累计弧长表，再按弧长s均匀重采样成 s -> u 索引；
+ * 之后任意弧长处的查询都是一次乘法加一次线性插值 (O(1))，无需逐点求根。
+ * 以恒定速度v沿路径运动只需取 s = v·t。
+ */
+class ArcLengthPath
+{
+public:
+    using Curve = std::function<Vector3f(float u)>;
+
+    static constexpr int kDefaultResolution = 2048;  // 均匀弧长索引的段数
+
+    ArcLengthPath() = default;
+
+    /**
+     * @brief 构建弧长表
+     * @param curve 曲线 p(u)
+     * @param u0 参数起点
+     * @param u1 参数终点
+     * @param resolution 弧长索引段数 (累计弧长表为其4倍细分)
+     * @return 曲线长度是否非零
+     */
+    bool build(Curve curve, float u0, float u1, int resolution = kDefaultResolution);
+
+    bool empty() const { return uAtS_.empty(); }
+    float length() const { return length_; }
+
+    /**
+     * @brief 弧长s处的曲线参数u (O(1)，s超出范围时钳位)
+     */
+    float parameterAt(float s) const;
+
+    /**
+     * @brief 弧长s处的位置
+     */
+    Vector3f position(float s) const;
+
+    /**
+     * @brief 弧长s处以切向速度speed、切向加速度accel运动时的轨迹点 (含向心加速度)
+     */
+    TrajectoryPoint evaluate(float s, float speed, float accel = 0.0f) const;
+
+    // ==================== 常用曲线 ====================
+
+    /// 直线 a -> b，u∈[0, 1]
+    static Curve line(const Vector3f& a, const Vector3f& b);
+    /// XY平面圆，u为角度 (rad)，从 center + (radius, 0, 0) 出发
+    static Curve circle(const Vector3f& center, float radius);
+    /// XY平面8字形 (Gerono双纽线)，u∈[0, 2π]，宽度为2·size
+    static Curve figureEight(const Vector3f& center, float size);
+    /// XY平面阿基米德螺线，半径从0线性增大到radius，u∈[0, 1]
+    static Curve spiral(const Vector3f& center, float radius, float turns);
+    /// 绕Z轴螺旋线，u为角度 (rad)，每弧度上升risePerRadian
+    static Curve helix(const Vector3f& center, float radius, float risePerRadian);
+
+private:
+    Curve curve_;
+    std::vector<float> uAtS_;  // uAtS_[k] 为弧长 k·length/resolution 处的参数
+    float length_ = 0.0f;
+    float step_ = 0.0f;        // 索引弧长间隔
+    float invStep_ = 0.0f;
+};
+
+#endif // ARC_LENGTH_PATH_H
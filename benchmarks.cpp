@@ -0,0 +1,1225 @@
+#include "benchmarks.h"
+#include "FIFO.h"
+#include "SerialPort.h"
+#include "can_frame_codec.h"
+#include "can_frame_ring.h"
+#include "can_rx_queue.h"
+#include "fused_serial_io.h"
+#include "online_trajectory_filter.h"
+#include "realtime_runtime.h"
+#include "state_exchange.h"
+#include "multirate_scheduler.h"
+#include "spsc_ring.h"
+#include "trace_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <poll.h>
+#include <random>
+#include <termios.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// 线程CPU时间 (纳秒)：不计被抢占的时间，用于衡量计算本身的最坏耗时
+int64_t threadCpuNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+struct Benchmark
+{
+    const char* name;
+    const char* description;
+    std::function<int()> run;
+};
+
+// 打印耗时分布，返回最大值 (微秒)
+double reportLatency(const char* label, std::vector<double>& samplesUs)
+{
+    std::sort(samplesUs.begin(), samplesUs.end());
+    const size_t n = samplesUs.size();
+    double sum = 0.0;
+    for (double v : samplesUs) {
+        sum += v;
+    }
+    std::printf("%-24s n=%zu mean=%.3fus p50=%.3fus p99=%.3fus p99.9=%.3fus max=%.3fus\n",
+                label, n, sum / n, samplesUs[n / 2], samplesUs[n * 99 / 100],
+                samplesUs[n * 999 / 1000], samplesUs.back());
+    return samplesUs.back();
+}
+
+// 伪终端回环：主端模拟电机总线，从端 (原始模式、VMIN=0/VTIME=0) 模拟串口
+struct PtyLoopback
+{
+    int master = -1;
+    int slave = -1;
+
+    bool open()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            return false;
+        }
+        slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+        if (slave < 0) {
+            return false;
+        }
+        termios option;
+        tcgetattr(slave, &option);
+        cfmakeraw(&option);
+        option.c_cc[VMIN] = 0;
+        option.c_cc[VTIME] = 0;
+        return tcsetattr(slave, TCSANOW, &option) == 0;
+    }
+
+    ~PtyLoopback()
+    {
+        if (slave >= 0) ::close(slave);
+        if (master >= 0) ::close(master);
+    }
+};
+
+// 总线模拟：每1ms写出三个关节的状态帧，读回三条指令帧 (或超时)，
+// 记录 状态帧写出 → 指令全部收到 的延迟 (微秒)
+std::vector<double> simulateBus(int master, int rounds)
+{
+    std::vector<double> latencies;
+    latencies.reserve(rounds);
+    uint8_t frames[3 * CanFrameCodec::kFrameLength];
+    for (int j = 0; j < 3; ++j) {
+        uint8_t* frame = frames + j * CanFrameCodec::kFrameLength;
+        const uint8_t status[CanFrameCodec::kFrameLength] = {0xAA, 0x11, 0x08, 0x00, 0x00, 0x00, 0x00,
+                                                             static_cast<uint8_t>(17 + j), 0x7F, 0xFF, 0x7F,
+                                                             0xF7, 0xFF, 0x1B, 0x19, 0x55};
+        std::memcpy(frame, status, sizeof(status));
+    }
+
+    constexpr size_t kCommandBytes = 3 * CanFrameCodec::kCommandLength;
+    uint8_t buffer[512];
+    PeriodicTimer timer(Clock::kNsPerMs);
+    timer.start();
+    for (int k = 0; k < rounds; ++k) {
+        const int64_t sent = Clock::now();
+        if (::write(master, frames, sizeof(frames)) != static_cast<ssize_t>(sizeof(frames))) {
+            break;
+        }
+        size_t received = 0;
+        while (received < kCommandBytes) {
+            pollfd pfd{master, POLLIN, 0};
+            if (::poll(&pfd, 1, 20) <= 0) {
+                break;
+            }
+            const ssize_t n = ::read(master, buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            received += static_cast<size_t>(n);
+        }
+        if (received >= kCommandBytes) {
+            latencies.push_back((Clock::now() - sent) * 1e-3);
+        }
+        timer.wait();
+    }
+    return latencies;
+}
+
+// 向串口写出三个关节的指令
+void sendCommands(int fd, const std::array<JointState, JointStateExchange::kJointCount + 1>& states)
+{
+    for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+        CanFrameCodec::CommandFrame command;
+        CanFrameCodec::encodePosVel(joint, states[joint].position, 0.0f, command);
+        (void)::write(fd, command.data(), command.size());
+    }
+}
+
+// 设定点滤波器：三关节每周期一次update，目标随机跳变，检查最坏耗时是否小于250us周期
+// (按线程CPU时间计，包含计时调用本身的开销，结果偏保守)
+int benchOnlineFilter()
+{
+    constexpr int kCycles = 1000000;
+    constexpr float kPeriod = 250e-6f;
+    constexpr double kBudgetUs = 250.0;
+
+    OnlineTrajectoryFilter filter;
+    for (int axis = 0; axis < 3; ++axis) {
+        filter.reset(axis, 0.0f);
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+    Vector3f targetPos = Vector3f::Zero();
+    Vector3f targetVel = Vector3f::Zero();
+
+    std::vector<double> samples;
+    samples.reserve(kCycles);
+    float checksum = 0.0f;
+    for (int k = 0; k < kCycles; ++k) {
+        if (k % 200 == 0) {
+            targetPos = Vector3f(position(rng), position(rng), position(rng));
+            targetVel = Vector3f(velocity(rng), velocity(rng), velocity(rng));
+        }
+        const int64_t begin = threadCpuNs();
+        const TrajectoryPoint command = filter.update(targetPos, targetVel, kPeriod);
+        const int64_t end = threadCpuNs();
+        checksum += command.position[0];
+        samples.push_back((end - begin) * 1e-3);
+    }
+
+    const double worst = reportLatency("online_filter (3 axes)", samples);
+    std::printf("checksum=%f budget=%.0fus -> %s\n", checksum, kBudgetUs, worst < kBudgetUs ? "PASS" : "FAIL");
+    return worst < kBudgetUs ? 0 : 1;
+}
+
+// 控制周期抖动：1kHz绝对时刻唤醒，先按默认实时参数尝试提权 (非root时降级为普通线程)
+int benchCycleJitter()
+{
+    constexpr int kCycles = 10000;
+    constexpr int64_t kPeriodNs = 1000000;
+
+    RealtimeParams params;
+    params.enabled = true;
+    RealtimeRuntime runtime(params);
+    runtime.enter();
+    std::printf("realtime: %s\n", runtime.status().message.c_str());
+
+    PeriodicTimer timer(kPeriodNs);
+    std::vector<double> latencies;
+    latencies.reserve(kCycles);
+    timer.start();
+    int64_t previousSum = 0;
+    for (int k = 0; k < kCycles; ++k) {
+        // 每周期唤醒延迟 = 累计延迟的增量 (超时周期不计入)
+        if (!timer.wait()) {
+            latencies.push_back((timer.stats().sumWakeLatencyNs - previousSum) * 1e-3);
+        }
+        previousSum = timer.stats().sumWakeLatencyNs;
+    }
+    runtime.leave();
+
+    const CycleStats& stats = timer.stats();
+    if (!latencies.empty()) {
+        reportLatency("wake latency (1kHz)", latencies);
+    }
+    std::printf("cycles=%llu overruns=%llu missed=%llu max_latency=%.1fus\n",
+                static_cast<unsigned long long>(stats.cycles), static_cast<unsigned long long>(stats.overruns),
+                static_cast<unsigned long long>(stats.missedCycles), stats.maxWakeLatencyNs * 1e-3);
+    return stats.overruns == 0 ? 0 : 1;
+}
+
+// 多速率调度：4kHz节拍上运行内环 (每拍)、1kHz轨迹和100Hz监控，各任务用忙等模拟固定计算量，
+// 分别统计各速率的耗时与超预算次数，以及节拍的唤醒延迟和超时
+int benchMultiRate()
+{
+    constexpr int64_t kTickNs = 250 * 1000;
+    constexpr int kTicks = 8000;
+
+    auto spin = [](int64_t ns) {
+        const int64_t until = Clock::now() + ns;
+        while (Clock::now() < until) {
+        }
+    };
+
+    MultiRateScheduler scheduler(kTickNs);
+    std::string error;
+    bool ok = scheduler.addTask("inner", kTickNs, kTickNs / 4, [&](int64_t) { spin(15 * 1000); }, 0, &error);
+    ok = ok && scheduler.addTask("trajectory", 4 * kTickNs, kTickNs / 2, [&](int64_t) { spin(60 * 1000); }, 0, &error);
+    ok = ok && scheduler.addTask("supervisory", 40 * kTickNs, kTickNs / 4, [&](int64_t) { spin(30 * 1000); }, 1, &error);
+    if (!ok) {
+        std::printf("%s\n", error.c_str());
+        return 1;
+    }
+    std::printf("utilization=%.2f worst_tick_budget=%lldus\n", scheduler.budgetUtilization(),
+                static_cast<long long>(scheduler.worstTickBudget() / 1000));
+
+    PeriodicTimer timer(kTickNs);
+    timer.start();
+    for (int k = 0; k < kTicks; ++k) {
+        scheduler.tick(Clock::now());
+        timer.wait();
+    }
+
+    for (const MultiRateScheduler::RateStats& rate : scheduler.stats()) {
+        std::printf("%-12s period=%6.0fus runs=%6llu mean=%6.1fus max=%6.1fus over_budget=%llu\n", rate.name,
+                    rate.periodNs * 1e-3, static_cast<unsigned long long>(rate.runs), rate.meanComputeUs(),
+                    rate.maxComputeNs * 1e-3, static_cast<unsigned long long>(rate.overBudget));
+    }
+    const CycleStats& stats = timer.stats();
+    std::printf("ticks=%llu overruns=%llu missed=%llu mean_latency=%.1fus max_latency=%.1fus\n",
+                static_cast<unsigned long long>(stats.cycles), static_cast<unsigned long long>(stats.overruns),
+                static_cast<unsigned long long>(stats.missedCycles), stats.meanWakeLatencyUs(),
+                stats.maxWakeLatencyNs * 1e-3);
+    return 0;
+}
+
+// 流水线延迟：伪终端回环上对比多线程流水线 (接收线程 → FIFO+互斥锁+条件变量 → 解析线程 →
+// 状态交换区 → 控制线程写指令) 与融合流水线 (单线程 读 → 解析 → 控制 → 写) 的 状态帧 → 指令 延迟
+int benchFusedPipeline()
+{
+    constexpr int kRounds = 2000;
+    constexpr int64_t kTimeoutNs = 5 * Clock::kNsPerMs;
+
+    // 多线程流水线
+    std::vector<double> threaded;
+    {
+        PtyLoopback pty;
+        if (!pty.open()) {
+            std::printf("openpty failed\n");
+            return 1;
+        }
+        SpscRing<CanRxRecord> queue(256);
+        JointStateExchange exchange;
+        std::atomic_bool running{true};
+
+        std::thread rx([&]() {
+            CanFrameRing ring;
+            while (running.load()) {
+                pollfd pfd{pty.slave, POLLIN, 0};
+                if (::poll(&pfd, 1, 2) <= 0) {
+                    continue;
+                }
+                uint8_t* recvPtr = ring.writePtr();
+                const ssize_t n = ::read(pty.slave, recvPtr, ring.writable());
+                if (n <= 0) {
+                    continue;
+                }
+                const int64_t rxTimeNs = Clock::now();
+                ring.commit(static_cast<size_t>(n));
+                CanRxRecord record;
+                record.rxTimeNs = rxTimeNs;
+                CanFrameRing::View view;
+                while (ring.next(view) == CanFrameCodec::ExtractResult::GotFrame) {
+                    std::copy(view.data, view.data + CanFrameCodec::kFrameLength, record.frame.begin());
+                    queue.push(record);
+                }
+            }
+        });
+        std::thread parser([&]() {
+            CanRxRecord record;
+            while (running.load()) {
+                if (!queue.pop(record)) {
+                    queue.waitForData(2 * Clock::kNsPerMs);
+                    continue;
+                }
+                JointState state;
+                if (CanFrameCodec::decodeState(record.frame, record.rxTimeNs, state)) {
+                    exchange.publish(state);
+                }
+            }
+        });
+        std::thread control([&]() {
+            JointStateExchange::Versions consumed = exchange.versions();
+            std::array<JointState, JointStateExchange::kJointCount + 1> states;
+            while (running.load()) {
+                if (!exchange.waitForFreshSet(consumed, Clock::now() + kTimeoutNs)) {
+                    continue;
+                }
+                for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                    exchange.read(joint, states[joint]);
+                }
+                sendCommands(pty.slave, states);
+            }
+        });
+
+        threaded = simulateBus(pty.master, kRounds);
+        running.store(false);
+        queue.wakeConsumer();
+        rx.join();
+        parser.join();
+        control.join();
+    }
+
+    // 融合流水线
+    std::vector<double> fused;
+    {
+        PtyLoopback pty;
+        if (!pty.open()) {
+            std::printf("openpty failed\n");
+            return 1;
+        }
+        JointStateExchange exchange;
+        std::atomic_bool running{true};
+        std::thread loop([&]() {
+            FusedSerialIo io(pty.slave, exchange);
+            JointStateExchange::Versions consumed = exchange.versions();
+            std::array<JointState, JointStateExchange::kJointCount + 1> states;
+            while (running.load()) {
+                io.poll(Clock::now() + kTimeoutNs);
+                if (!exchange.waitForFreshSet(consumed, 0)) {
+                    continue;
+                }
+                for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                    exchange.read(joint, states[joint]);
+                }
+                sendCommands(pty.slave, states);
+            }
+        });
+
+        fused = simulateBus(pty.master, kRounds);
+        running.store(false);
+        loop.join();
+    }
+
+    if (threaded.empty() || fused.empty()) {
+        std::printf("no round trips completed (threaded=%zu fused=%zu)\n", threaded.size(), fused.size());
+        return 1;
+    }
+    reportLatency("threaded rx->tx", threaded);
+    reportLatency("fused rx->tx", fused);
+    return 0;
+}
+
+// 原接收线程的提取方式：字节流存放在vector中，std::find找帧头，每取一帧从头部erase
+CanFrameCodec::ExtractResult vectorExtract(std::vector<uint8_t>& streamBuf, CanFrameCodec::Frame& frame)
+{
+    auto headIter = std::find(streamBuf.begin(), streamBuf.end(), CanFrameCodec::kHead);
+    if (headIter == streamBuf.end()) {
+        streamBuf.clear();
+        return CanFrameCodec::ExtractResult::NoFrame;
+    }
+    if (static_cast<size_t>(std::distance(headIter, streamBuf.end())) < CanFrameCodec::kFrameLength) {
+        streamBuf.erase(streamBuf.begin(), headIter);
+        return CanFrameCodec::ExtractResult::NeedMoreData;
+    }
+    if (*(headIter + CanFrameCodec::kFrameLength - 1) == CanFrameCodec::kTail) {
+        std::copy(headIter, headIter + CanFrameCodec::kFrameLength, frame.begin());
+        streamBuf.erase(streamBuf.begin(), headIter + CanFrameCodec::kFrameLength);
+        return CanFrameCodec::ExtractResult::GotFrame;
+    }
+    streamBuf.erase(streamBuf.begin(), headIter + 1);
+    return CanFrameCodec::ExtractResult::NoFrame;
+}
+
+// 帧提取吞吐：合成字节流 (状态帧、ACK帧、夹杂0xAA的UART字节) 按1-64字节的随机块喂入，
+// 比较 vector+erase 与 环形缓冲+memchr 两种提取方式每秒提取的帧数，并核对提取的帧数一致
+int benchCanFrameRing()
+{
+    constexpr int kFrames = 200000;
+    constexpr int kPasses = 5;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> kindDist(0, 9);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_int_distribution<int> uartLenDist(1, 24);
+    std::vector<uint8_t> stream;
+    stream.reserve(kFrames * 24);
+    int expected = 0;
+    for (int k = 0; k < kFrames; ++k) {
+        const int kind = kindDist(rng);
+        if (kind == 0) {
+            // UART数据，其中的0xAA后面不会正好在第15个字节出现0x55
+            const int len = uartLenDist(rng);
+            for (int i = 0; i < len; ++i) {
+                const uint8_t b = static_cast<uint8_t>(byteDist(rng));
+                stream.push_back(b == CanFrameCodec::kTail ? 0x00 : b);
+            }
+            continue;
+        }
+        uint8_t frame[CanFrameCodec::kFrameLength] = {0xAA, 0x11, 0x08, 0x00, 0x00, 0x00, 0x00,
+                                                      static_cast<uint8_t>(17 + k % 3), 0x7F, 0xFF, 0x7F,
+                                                      0xF7, 0xFF, 0x1B, 0x19, 0x55};
+        if (kind == 1) {
+            frame[1] = 0x12;   // ACK帧
+        }
+        for (size_t i = 8; i < 15; ++i) {
+            const uint8_t b = static_cast<uint8_t>(byteDist(rng));
+            frame[i] = b == CanFrameCodec::kHead ? 0x00 : b;
+        }
+        stream.insert(stream.end(), frame, frame + sizeof(frame));
+        ++expected;
+    }
+    auto report = [&](const char* label, int64_t elapsedNs, int frames) {
+        const double seconds = elapsedNs * 1e-9;
+        std::printf("  %-14s frames=%d  %.2f Mframes/s  %.1f MB/s  %.1f ns/frame\n", label, frames,
+                    frames * kPasses / seconds * 1e-6, stream.size() * kPasses / seconds * 1e-6,
+                    static_cast<double>(elapsedNs) / (static_cast<double>(frames) * kPasses));
+    };
+
+    // 每次read得到的字节数：正常接收时为几十字节，线程被延迟后一次读出积压的数据
+    struct ChunkSize
+    {
+        const char* name;
+        int minBytes;
+        int maxBytes;
+    };
+    const ChunkSize chunkSizes[] = {{"1-64B", 1, 64}, {"256-1024B", 256, 1024}};
+
+    int failures = 0;
+    uint64_t checksum = 0;
+    for (const ChunkSize& chunkSize : chunkSizes) {
+        std::vector<size_t> chunks;
+        std::uniform_int_distribution<int> chunkDist(chunkSize.minBytes, chunkSize.maxBytes);
+        for (size_t pos = 0; pos < stream.size();) {
+            const size_t len = std::min(stream.size() - pos, static_cast<size_t>(chunkDist(rng)));
+            chunks.push_back(len);
+            pos += len;
+        }
+        std::printf("read size %s:\n", chunkSize.name);
+
+        int vectorFrames = 0;
+        int64_t begin = Clock::now();
+        for (int pass = 0; pass < kPasses; ++pass) {
+            std::vector<uint8_t> streamBuf;
+            streamBuf.reserve(2048);
+            vectorFrames = 0;
+            const uint8_t* src = stream.data();
+            for (size_t len : chunks) {
+                streamBuf.insert(streamBuf.end(), src, src + len);
+                src += len;
+                CanFrameCodec::Frame frame;
+                CanFrameCodec::ExtractResult result;
+                while ((result = vectorExtract(streamBuf, frame)) != CanFrameCodec::ExtractResult::NeedMoreData) {
+                    if (result == CanFrameCodec::ExtractResult::GotFrame) {
+                        checksum += frame[8];
+                        ++vectorFrames;
+                    } else if (streamBuf.empty()) {
+                        break;
+                    }
+                }
+            }
+        }
+        report("vector+erase", Clock::now() - begin, vectorFrames);
+
+        int ringFrames = 0;
+        begin = Clock::now();
+        for (int pass = 0; pass < kPasses; ++pass) {
+            CanFrameRing ring;
+            ringFrames = 0;
+            const uint8_t* src = stream.data();
+            for (size_t len : chunks) {
+                ring.append(src, len);
+                src += len;
+                CanFrameRing::View view;
+                CanFrameCodec::ExtractResult result;
+                while ((result = ring.next(view)) != CanFrameCodec::ExtractResult::NeedMoreData) {
+                    if (result == CanFrameCodec::ExtractResult::GotFrame) {
+                        checksum += view[8];
+                        ++ringFrames;
+                    }
+                }
+            }
+        }
+        report("ring+memchr", Clock::now() - begin, ringFrames);
+
+        if (vectorFrames != expected || ringFrames != expected) {
+            ++failures;
+        }
+    }
+    std::printf("expected frames=%d checksum=%llu\n", expected, static_cast<unsigned long long>(checksum));
+
+    return failures == 0 ? 0 : 1;
+}
+
+// 接收线程 → 解析线程的CAN记录交接：原FIFO+互斥锁+条件变量 与 无锁SPSC队列 (逐条/批量)，
+// 单线程 写入+取出 一条的耗时 (无争用的操作成本) 和两个线程流水传递的吞吐
+int benchSpscHandoff()
+{
+    constexpr int kRecords = 1000000;
+    constexpr int kRecordSize = static_cast<int>(sizeof(CanRxRecord));
+    constexpr size_t kBatch = 16;
+    int failures = 0;
+
+    auto report = [](const char* label, int64_t elapsedNs, int records) {
+        std::printf("%-28s %.1f ns/record\n", label, static_cast<double>(elapsedNs) / records);
+    };
+
+    // 单线程：每条记录写入后立即取出
+    {
+        FIFO fifo(4096);
+        std::mutex fifoMutex;
+        std::condition_variable fifoReady;
+        CanRxRecord record;
+        int64_t sum = 0;
+        const int64_t begin = Clock::now();
+        for (int k = 0; k < kRecords; ++k) {
+            record.rxTimeNs = k;
+            {
+                std::lock_guard<std::mutex> lock(fifoMutex);
+                fifo.WriteBuffer(reinterpret_cast<const unsigned char*>(&record), 0, kRecordSize);
+                fifoReady.notify_one();
+            }
+            {
+                std::lock_guard<std::mutex> lock(fifoMutex);
+                fifo.ReadBuffer(reinterpret_cast<unsigned char*>(&record), 0, kRecordSize);
+                fifo.Clear(kRecordSize);
+            }
+            sum += record.rxTimeNs;
+        }
+        report("fifo+mutex push/pop", Clock::now() - begin, kRecords);
+        failures += sum == int64_t(kRecords) * (kRecords - 1) / 2 ? 0 : 1;
+    }
+    for (bool wakeups : {true, false}) {
+        SpscRing<CanRxRecord> queue(256, wakeups);
+        CanRxRecord record;
+        int64_t sum = 0;
+        const int64_t begin = Clock::now();
+        for (int k = 0; k < kRecords; ++k) {
+            record.rxTimeNs = k;
+            queue.push(record);
+            queue.pop(record);
+            sum += record.rxTimeNs;
+        }
+        report(wakeups ? "spsc push/pop" : "spsc push/pop (no wakeups)", Clock::now() - begin, kRecords);
+        failures += sum == int64_t(kRecords) * (kRecords - 1) / 2 ? 0 : 1;
+    }
+
+    // 两个线程：生产者连续写入，消费者取出并核对顺序
+    {
+        FIFO fifo(4096);
+        std::mutex fifoMutex;
+        std::condition_variable fifoReady;
+        bool ordered = true;
+        const int64_t begin = Clock::now();
+        std::thread consumer([&]() {
+            CanRxRecord record;
+            for (int k = 0; k < kRecords; ++k) {
+                std::unique_lock<std::mutex> lock(fifoMutex);
+                fifoReady.wait(lock, [&]() { return fifo.GetDataCount() >= kRecordSize; });
+                fifo.ReadBuffer(reinterpret_cast<unsigned char*>(&record), 0, kRecordSize);
+                fifo.Clear(kRecordSize);
+                ordered = ordered && record.rxTimeNs == k;
+            }
+        });
+        CanRxRecord record;
+        for (int k = 0; k < kRecords;) {
+            std::lock_guard<std::mutex> lock(fifoMutex);
+            if (fifo.GetReserveCount() < kRecordSize) {
+                continue;
+            }
+            record.rxTimeNs = k++;
+            fifo.WriteBuffer(reinterpret_cast<const unsigned char*>(&record), 0, kRecordSize);
+            fifoReady.notify_one();
+        }
+        consumer.join();
+        report("fifo+mutex 2 threads", Clock::now() - begin, kRecords);
+        failures += ordered ? 0 : 1;
+    }
+    for (size_t batch : {size_t(1), kBatch}) {
+        SpscRing<CanRxRecord> queue(256);
+        bool ordered = true;
+        const int64_t begin = Clock::now();
+        std::thread consumer([&]() {
+            CanRxRecord records[kBatch];
+            for (int k = 0; k < kRecords;) {
+                const size_t n = queue.popBatch(records, batch);
+                if (n == 0) {
+                    queue.waitForData(Clock::kNsPerMs);
+                    continue;
+                }
+                for (size_t i = 0; i < n; ++i, ++k) {
+                    ordered = ordered && records[i].rxTimeNs == k;
+                }
+            }
+        });
+        CanRxRecord records[kBatch];
+        for (int k = 0; k < kRecords;) {
+            const size_t count = std::min<size_t>(batch, kRecords - k);
+            for (size_t i = 0; i < count; ++i) {
+                records[i].rxTimeNs = k + static_cast<int>(i);
+            }
+            const size_t n = queue.pushBatch(records, count);
+            if (n < count) {
+                // 队列满：只重发未写入的部分
+                for (size_t i = 0; i + n < count; ++i) {
+                    records[i] = records[i + n];
+                }
+                k += static_cast<int>(n);
+                std::this_thread::yield();
+                continue;
+            }
+            k += static_cast<int>(n);
+        }
+        consumer.join();
+        report(batch == 1 ? "spsc 2 threads" : "spsc batch16 2 threads", Clock::now() - begin, kRecords);
+        failures += ordered ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+// CAN接收队列溢出策略：每1ms (虚拟时间) 三个电机各来一帧状态，解析线程前2s每毫秒随机处理0-4条 (平均2条，积压)，
+// 之后每毫秒处理6条 (追赶)。统计每毫秒末解析线程已发布的各关节状态的年龄，以及队列的溢出计数
+int benchCanRxOverflow()
+{
+    constexpr int kSteps = 4000;
+    constexpr int kSlowSteps = 2000;
+    constexpr size_t kCapacity = 64;
+
+    const CanRxQueue::OverflowPolicy policies[] = {CanRxQueue::OverflowPolicy::DropNewest,
+                                                   CanRxQueue::OverflowPolicy::DropOldest,
+                                                   CanRxQueue::OverflowPolicy::LatestValue};
+    int failures = 0;
+    for (CanRxQueue::OverflowPolicy policy : policies) {
+        CanRxQueue queue(kCapacity, policy);
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> slowBudget(0, 4);
+        std::array<int64_t, JointStateExchange::kJointCount + 1> latestNs{};
+        std::vector<double> ageMs;
+        ageMs.reserve(kSteps * JointStateExchange::kJointCount);
+        uint64_t consumed = 0;
+        for (int step = 0; step < kSteps; ++step) {
+            const int64_t nowNs = static_cast<int64_t>(step) * Clock::kNsPerMs;
+            for (int j = 0; j < JointStateExchange::kJointCount; ++j) {
+                CanRxRecord record;
+                record.frame = {0xAA, 0x11, 0x08, 0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>(17 + j),
+                                0x7F, 0xFF, 0x7F, 0xF7, 0xFF, 0x1B, 0x19, 0x55};
+                record.rxTimeNs = nowNs;
+                queue.push(record);
+            }
+            const size_t budget = step < kSlowSteps ? static_cast<size_t>(slowBudget(rng)) : 6;
+            CanRxRecord records[6];
+            const size_t n = queue.popBatch(records, budget);
+            for (size_t i = 0; i < n; ++i) {
+                JointState state;
+                if (CanFrameCodec::decodeState(records[i].frame, records[i].rxTimeNs, state)) {
+                    latestNs[state.jointIndex] = std::max(latestNs[state.jointIndex], state.timestampNs);
+                    ++consumed;
+                }
+            }
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                ageMs.push_back((nowNs - latestNs[joint]) * 1e-6);
+            }
+        }
+
+        const CanRxQueue::Stats stats = queue.stats();
+        std::sort(ageMs.begin(), ageMs.end());
+        double sum = 0.0;
+        for (double v : ageMs) {
+            sum += v;
+        }
+        std::printf("%-13s state age mean=%.1fms p99=%.1fms max=%.1fms | consumed=%llu pushed=%llu "
+                    "overflows=%llu dropped=%llu superseded=%llu highWater=%llu/%llu\n",
+                    CanRxQueue::policyName(policy), sum / ageMs.size(), ageMs[ageMs.size() * 99 / 100],
+                    ageMs.back(), static_cast<unsigned long long>(consumed),
+                    static_cast<unsigned long long>(stats.pushed), static_cast<unsigned long long>(stats.overflows),
+                    static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.superseded),
+                    static_cast<unsigned long long>(stats.highWater), static_cast<unsigned long long>(stats.capacity));
+        if (stats.pushed != static_cast<uint64_t>(kSteps) * JointStateExchange::kJointCount) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// CAN解析批量取出：回放三个关节的状态帧记录，每次向队列写入一段突发 (1/8/32条) 后由解析循环取空，
+// 逐帧 (每条pop、解码、发布) 与批量 (一次取出、解码、每关节发布一次) 的吞吐和每帧CPU时间；
+// 发布与 ControlWorker::updateJointState 相同 (状态交换区 + 反馈组装)
+int benchCanParserBatch()
+{
+    constexpr int kFrames = 600000;
+    constexpr size_t kMaxBatch = 64;
+
+    std::vector<CanRxRecord> replay(kFrames);
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    for (int k = 0; k < kFrames; ++k) {
+        CanRxRecord& record = replay[k];
+        record.frame = {0xAA, 0x11, 0x08, 0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>(17 + k % 3),
+                        static_cast<uint8_t>(byteDist(rng)), static_cast<uint8_t>(byteDist(rng)),
+                        static_cast<uint8_t>(byteDist(rng)), static_cast<uint8_t>(byteDist(rng)),
+                        0xFF, 0x1B, 0x19, 0x55};
+        record.rxTimeNs = static_cast<int64_t>(k / 3) * Clock::kNsPerMs;
+    }
+
+    int failures = 0;
+    for (size_t burst : {size_t(1), size_t(8), size_t(32)}) {
+        for (size_t batchSize : {size_t(1), kMaxBatch}) {
+            CanRxQueue queue(256, CanRxQueue::OverflowPolicy::DropNewest);
+            JointStateExchange exchange;
+            FeedbackAssembler assembler;
+            CanRxRecord records[kMaxBatch];
+            JointStateBatch batch;
+            uint64_t published = 0;
+            uint64_t frames = 0;
+
+            const int64_t cpuStart = threadCpuNs();
+            const int64_t wallStart = Clock::now();
+            for (size_t pos = 0; pos < replay.size(); pos += burst) {
+                const size_t end = std::min(replay.size(), pos + burst);
+                for (size_t k = pos; k < end; ++k) {
+                    queue.push(replay[k]);
+                }
+                size_t count;
+                while ((count = queue.popBatch(records, batchSize)) > 0) {
+                    batch.clear();
+                    for (size_t i = 0; i < count; ++i) {
+                        batch.add(records[i]);
+                    }
+                    for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                        if (batch.has(joint)) {
+                            exchange.publish(batch.latest[joint]);
+                            assembler.publish(batch.latest[joint]);
+                            ++published;
+                        }
+                    }
+                    frames += count;
+                }
+            }
+            const int64_t wallNs = Clock::now() - wallStart;
+            const int64_t cpuNs = threadCpuNs() - cpuStart;
+
+            std::printf("burst=%-3zu %-9s %.2f Mframes/s  cpu=%.1f ns/frame  publishes/frame=%.2f\n", burst,
+                        batchSize == 1 ? "per-frame" : "batch", frames / (wallNs * 1e-9) * 1e-6,
+                        static_cast<double>(cpuNs) / frames, static_cast<double>(published) / frames);
+            JointState last;
+            if (frames != replay.size() || !exchange.read(3, last) || last.timestampNs != replay.back().rxTimeNs) {
+                ++failures;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// 跟踪日志：每帧记录一条CAN帧时，调用处的耗时 —— 级别关闭 / 写入二进制记录 / 当场格式化十六进制文本
+// (原每帧QString拼接的非Qt近似)，以及消费线程取出、合并、格式化每条记录的耗时
+int benchTraceLog()
+{
+    constexpr int kCalls = 1000000;
+    const uint8_t frame[CanFrameCodec::kFrameLength] = {0xAA, 0x11, 0x08, 0x00, 0x00, 0x00, 0x00, 0x11,
+                                                        0x7F, 0xFF, 0x7F, 0xF7, 0xFF, 0x1B, 0x19, 0x55};
+    TraceLog& trace = TraceLog::instance();
+    trace.registerThread();
+    size_t sinkBytes = 0;
+    trace.setSink([&](const std::string& lines) { sinkBytes += lines.size(); });
+    const TraceLevel previous = TraceLog::level();
+
+    auto report = [](const char* label, int64_t elapsedNs, int calls) {
+        std::printf("%-26s %.2f ns/call\n", label, static_cast<double>(elapsedNs) / calls);
+    };
+
+    // 级别关闭
+    TraceLog::setLevel(TraceLevel::Info);
+    int64_t begin = Clock::now();
+    for (int k = 0; k < kCalls; ++k) {
+        TRACE_EVENT(TraceLevel::Debug, TraceEvent::CanFrame, frame, sizeof(frame));
+    }
+    report("disabled (level=info)", Clock::now() - begin, kCalls);
+
+    // 写入：每写一批 (每批输出行数上限) 由本线程取空 (消费线程未启动)，取空的耗时另计
+    TraceLog::setLevel(TraceLevel::Debug);
+    constexpr int kChunk = static_cast<int>(TraceLog::kMaxLinesPerDrain);
+    int64_t writeNs = 0;
+    int64_t drainNs = 0;
+    size_t drained = 0;
+    for (int k = 0; k < kCalls; k += kChunk) {
+        begin = Clock::now();
+        for (int i = 0; i < kChunk; ++i) {
+            TRACE_EVENT(TraceLevel::Debug, TraceEvent::CanFrame, frame, sizeof(frame));
+        }
+        const int64_t mid = Clock::now();
+        drained += trace.drain();
+        drainNs += Clock::now() - mid;
+        writeNs += mid - begin;
+    }
+    const int written = (kCalls + kChunk - 1) / kChunk * kChunk;
+    report("enabled binary write", writeNs, written);
+    report("consumer drain+format", drainNs, static_cast<int>(drained));
+
+    // 当场格式化
+    std::string sink;
+    begin = Clock::now();
+    for (int k = 0; k < kCalls; ++k) {
+        std::string line = "CAN Frame: ";
+        char hex[4];
+        for (uint8_t b : frame) {
+            std::snprintf(hex, sizeof(hex), "%02X ", b);
+            line += hex;
+        }
+        sink.swap(line);
+    }
+    report("eager hex formatting", Clock::now() - begin, kCalls);
+
+    const TraceLog::Stats stats = trace.stats();
+    std::printf("written=%llu dropped=%llu formatted=%llu suppressed=%llu sink=%zu bytes\n",
+                static_cast<unsigned long long>(stats.written), static_cast<unsigned long long>(stats.dropped),
+                static_cast<unsigned long long>(stats.formatted), static_cast<unsigned long long>(stats.suppressed),
+                sinkBytes);
+
+    TraceLog::setLevel(previous);
+    trace.setSink(nullptr);
+    return (stats.dropped == 0 && drained == static_cast<size_t>(written) && !sink.empty()) ? 0 : 1;
+}
+
+// 串口接收方式：伪终端上按随机间隔 (300-1300us) 写入状态帧，分别用select、忙轮询 (带/不带退避)
+// 和阻塞读 (VMIN=16) 接收，统计 写入 → 接收线程提取出整帧 的延迟和接收线程的CPU占用
+int benchSerialRx()
+{
+    constexpr int kFrames = 500;
+
+    struct Mode
+    {
+        const char* name;
+        SerialPort::RxMode mode;
+        bool backoff;
+    };
+    const Mode modes[] = {
+        {"select", SerialPort::RxMode::Select, false},
+        {"busy-poll", SerialPort::RxMode::BusyPoll, false},
+        {"busy-poll+backoff", SerialPort::RxMode::BusyPoll, true},
+        {"blocking", SerialPort::RxMode::Blocking, false},
+    };
+
+    for (const Mode& mode : modes) {
+        PtyLoopback pty;
+        if (!pty.open()) {
+            std::printf("openpty failed\n");
+            return 1;
+        }
+        SerialPort serial(ptsname(pty.master), B921600, 2);
+        serial.set_rx_mode(mode.mode, mode.backoff, static_cast<int>(CanFrameCodec::kFrameLength));
+
+        std::vector<std::atomic<int64_t>> sentNs(kFrames);
+        std::vector<double> latencies;
+        latencies.reserve(kFrames);
+        std::atomic_bool running{true};
+        int64_t cpuNs = 0;
+        int64_t wallNs = 1;
+
+        std::thread reader([&]() {
+            const int64_t wallStart = Clock::now();
+            const int64_t cpuStart = threadCpuNs();
+            CanFrameRing ring;
+            while (running.load()) {
+                uint8_t* recvPtr = ring.writePtr();
+                const ssize_t n = serial.recv(recvPtr, ring.writable());
+                if (n <= 0) {
+                    continue;
+                }
+                const int64_t now = Clock::now();
+                ring.commit(static_cast<size_t>(n));
+                CanFrameRing::View view;
+                while (ring.next(view) == CanFrameCodec::ExtractResult::GotFrame) {
+                    uint32_t seq = 0;
+                    std::memcpy(&seq, view.data + 8, sizeof(seq));
+                    if (seq < static_cast<uint32_t>(kFrames)) {
+                        latencies.push_back((now - sentNs[seq].load()) * 1e-3);
+                    }
+                }
+            }
+            cpuNs = threadCpuNs() - cpuStart;
+            wallNs = std::max<int64_t>(1, Clock::now() - wallStart);
+        });
+
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<int> gapUs(300, 1300);
+        uint8_t frame[CanFrameCodec::kFrameLength] = {0xAA, 0x11, 0x08, 0, 0, 0, 0, 17, 0, 0, 0, 0, 0, 0, 0, 0x55};
+        for (uint32_t seq = 0; seq < static_cast<uint32_t>(kFrames); ++seq) {
+            MonotonicClock().sleepUntil(Clock::now() + gapUs(rng) * 1000);
+            std::memcpy(frame + 8, &seq, sizeof(seq));
+            sentNs[seq].store(Clock::now());
+            (void)::write(pty.master, frame, sizeof(frame));
+        }
+        MonotonicClock().sleepUntil(Clock::now() + 5 * Clock::kNsPerMs);
+        running.store(false);
+        if (mode.mode == SerialPort::RxMode::Blocking) {
+            serial.interrupt_reader();
+        }
+        reader.join();
+
+        if (latencies.empty()) {
+            std::printf("%s: no frames received\n", mode.name);
+            return 1;
+        }
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s rx", mode.name);
+        reportLatency(label, latencies);
+        std::printf("%-24s cpu=%.1f%% frames=%zu/%d\n", "", 100.0 * cpuNs / wallNs, latencies.size(), kFrames);
+    }
+    return 0;
+}
+
+// 虚拟时钟：同一个周期定时器在VirtualClock下跑60秒轨迹时间，应远快于实时且统计与时间无关
+int benchVirtualClock()
+{
+    constexpr int64_t kPeriodNs = Clock::kNsPerMs;
+    constexpr int kCycles = 60000;
+
+    VirtualClock clock(Clock::kNsPerSec);
+    Clock::install(&clock);
+    const int64_t wallStart = threadCpuNs();
+
+    PeriodicTimer timer(kPeriodNs);
+    timer.start();
+    const int64_t simStart = clock.nowNs();
+    for (int k = 0; k < kCycles; ++k) {
+        clock.advance(kPeriodNs / 4);  // 模拟每周期1/4周期的计算耗时
+        timer.wait();
+    }
+    const int64_t simulatedNs = clock.nowNs() - simStart;
+    const int64_t wallNs = threadCpuNs() - wallStart;
+    Clock::install(nullptr);
+
+    const CycleStats& stats = timer.stats();
+    std::printf("simulated=%.3fs cpu=%.3fms speedup=%.0fx overruns=%llu max_compute=%.1fus\n",
+                Clock::toSeconds(simulatedNs), wallNs * 1e-6, static_cast<double>(simulatedNs) / wallNs,
+                static_cast<unsigned long long>(stats.overruns), stats.maxComputeNs * 1e-3);
+    const bool exact = simulatedNs == kCycles * kPeriodNs && stats.overruns == 0;
+    return exact ? 0 : 1;
+}
+
+// 状态年龄：写线程按1kHz发布三个关节的状态 (时间戳为发布时刻，模拟串口接收)，
+// 控制线程按1kHz周期读取，统计使用时刻的状态年龄和每次无锁读取的耗时
+int benchStateAge()
+{
+    constexpr int kCycles = 5000;
+    constexpr int64_t kPeriodNs = Clock::kNsPerMs;
+
+    JointStateExchange exchange;
+    std::atomic_bool running{true};
+    std::thread writer([&exchange, &running]() {
+        PeriodicTimer timer(kPeriodNs);
+        timer.start();
+        float position = 0.0f;
+        while (running.load(std::memory_order_relaxed)) {
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                exchange.publish(JointState(joint, position, 1.0f, Clock::now()));
+            }
+            position += 0.001f;
+            timer.wait();
+        }
+    });
+
+    std::vector<double> ages;
+    std::vector<double> readCosts;
+    ages.reserve(kCycles * JointStateExchange::kJointCount);
+    readCosts.reserve(kCycles);
+    PeriodicTimer timer(kPeriodNs);
+    timer.start();
+    uint64_t missing = 0;
+    for (int k = 0; k < kCycles; ++k) {
+        std::array<JointState, JointStateExchange::kJointCount + 1> states;
+        const int64_t begin = threadCpuNs();
+        bool complete = true;
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            complete = exchange.read(joint, states[joint]) && complete;
+        }
+        const int64_t end = threadCpuNs();
+        const int64_t now = Clock::now();
+        readCosts.push_back((end - begin) * 1e-3);
+        if (!complete) {
+            ++missing;
+        } else {
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                ages.push_back((now - states[joint].timestampNs) * 1e-3);
+            }
+        }
+        timer.wait();
+    }
+    running.store(false);
+    writer.join();
+
+    reportLatency("read 3 joints (cpu)", readCosts);
+    if (ages.empty()) {
+        std::printf("no state received\n");
+        return 1;
+    }
+    const double worstAge = reportLatency("state age at use", ages);
+    std::printf("missing=%llu updates=%llu max_age=%.1fus (period %.0fus)\n",
+                static_cast<unsigned long long>(missing),
+                static_cast<unsigned long long>(exchange.updates(1)), worstAge, kPeriodNs * 1e-3);
+    return 0;
+}
+
+// 反馈触发：写线程按1kHz发布三个关节 (相位与控制周期无关)，分别以定时器和
+// "凑齐一组新反馈"触发控制周期，比较计算开始时的状态年龄
+int benchFeedbackTrigger()
+{
+    constexpr int kCycles = 3000;
+    constexpr int64_t kPeriodNs = Clock::kNsPerMs;
+    constexpr int64_t kTimeoutNs = kPeriodNs * 3 / 2;
+
+    auto run = [](bool feedback, uint64_t& timeouts) {
+        JointStateExchange exchange;
+        std::atomic_bool running{true};
+        std::thread writer([&exchange, &running]() {
+            PeriodicTimer timer(kPeriodNs);
+            timer.start();
+            while (running.load(std::memory_order_relaxed)) {
+                for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                    exchange.publish(JointState(joint, 0.0f, 0.0f, Clock::now()));
+                }
+                timer.wait();
+            }
+        });
+
+        std::vector<double> ages;
+        ages.reserve(kCycles);
+        JointStateExchange::Versions consumed = exchange.versions();
+        PeriodicTimer timer(kPeriodNs);
+        timer.start();
+        for (int k = 0; k < kCycles; ++k) {
+            if (feedback) {
+                if (!exchange.waitForFreshSet(consumed, Clock::now() + kTimeoutNs)) {
+                    ++timeouts;
+                }
+            } else {
+                timer.wait();
+            }
+            const int64_t now = Clock::now();
+            JointState state;
+            if (k > 10 && exchange.read(1, state)) {
+                ages.push_back((now - state.timestampNs) * 1e-3);
+            }
+        }
+        running.store(false);
+        writer.join();
+        return ages;
+    };
+
+    uint64_t timerTimeouts = 0;
+    uint64_t feedbackTimeouts = 0;
+    std::vector<double> timerAges = run(false, timerTimeouts);
+    std::vector<double> feedbackAges = run(true, feedbackTimeouts);
+    if (timerAges.empty() || feedbackAges.empty()) {
+        std::printf("no state received\n");
+        return 1;
+    }
+    reportLatency("timer-triggered state age", timerAges);
+    reportLatency("feedback-triggered state age", feedbackAges);
+    const double timerMean = std::accumulate(timerAges.begin(), timerAges.end(), 0.0) / timerAges.size();
+    const double feedbackMean = std::accumulate(feedbackAges.begin(), feedbackAges.end(), 0.0) / feedbackAges.size();
+    std::printf("mean age: timer=%.1fus feedback=%.1fus timeouts=%llu\n", timerMean, feedbackMean,
+                static_cast<unsigned long long>(feedbackTimeouts));
+    return 0;
+}
+
+// 反馈同步：控制线程每1ms开启一轮指令，模拟总线线程对每轮依次回报三个关节
+// (关节间隔随机40-160us，关节3有2%丢帧)；对比按轮次组装的快照与直接读各关节最新状态时
+// 混入不同轮次状态的次数，并输出各关节缺失次数。轮次按接收时刻划分，
+// 总线回报拖到下一轮下发之后时仍会被归入新一轮，synced计数即反映这种情况
+int benchFeedbackSync()
+{
+    constexpr int kRounds = 3000;
+    constexpr int64_t kPeriodNs = Clock::kNsPerMs;
+    constexpr int64_t kSyncTimeoutNs = 600 * 1000;
+
+    JointStateExchange exchange;
+    FeedbackAssembler assembler(0x7);
+    std::atomic_bool running{true};
+    std::thread bus([&]() {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> gapUs(40, 160);
+        std::uniform_real_distribution<double> drop(0.0, 1.0);
+        uint64_t answered = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            const uint64_t round = assembler.currentRound();
+            if (round == answered) {
+                MonotonicClock().sleepUntil(Clock::now() + 20 * 1000);
+                continue;
+            }
+            answered = round;
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                MonotonicClock().sleepUntil(Clock::now() + gapUs(rng) * 1000);
+                if (joint == 3 && drop(rng) < 0.02) {
+                    continue;
+                }
+                // 位置字段记录轮次，便于检查读到的状态是否属于同一轮
+                const JointState state(joint, static_cast<float>(round), 0.0f, Clock::now());
+                exchange.publish(state);
+                assembler.publish(state);
+            }
+        }
+    });
+
+    PeriodicTimer timer(kPeriodNs);
+    timer.start();
+    uint64_t round = 0;
+    uint64_t mixedLatest = 0;
+    uint64_t mixedSynced = 0;
+    std::vector<double> waits;
+    waits.reserve(kRounds);
+    for (int k = 0; k < kRounds; ++k) {
+        if (round > 0) {
+            // 直接读最新状态：各关节可能来自不同轮次
+            std::array<JointState, JointStateExchange::kJointCount + 1> latest;
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                exchange.read(joint, latest[joint]);
+            }
+            if (latest[1].position != latest[2].position || latest[2].position != latest[3].position) {
+                ++mixedLatest;
+            }
+
+            const int64_t begin = Clock::now();
+            FeedbackSnapshot snapshot;
+            assembler.waitForRound(round, begin + kSyncTimeoutNs, snapshot);
+            waits.push_back((Clock::now() - begin) * 1e-3);
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                if (snapshot.reported(joint) && snapshot.joints[joint - 1].position != static_cast<float>(round)) {
+                    ++mixedSynced;
+                    break;
+                }
+            }
+        }
+        round = assembler.beginRound(Clock::now());
+        timer.wait();
+    }
+    running.store(false);
+    bus.join();
+
+    const FeedbackSyncStats stats = assembler.stats();
+    reportLatency("barrier wait", waits);
+    std::printf("rounds=%llu complete=%llu missing J1=%llu J2=%llu J3=%llu late=%llu max_skew=%.1fus\n",
+                static_cast<unsigned long long>(stats.rounds),
+                static_cast<unsigned long long>(stats.completeRounds),
+                static_cast<unsigned long long>(stats.missing[0]),
+                static_cast<unsigned long long>(stats.missing[1]),
+                static_cast<unsigned long long>(stats.missing[2]),
+                static_cast<unsigned long long>(stats.lateFrames), stats.maxSkewNs * 1e-3);
+    std::printf("mixed-round reads: latest=%llu synced=%llu\n",
+                static_cast<unsigned long long>(mixedLatest), static_cast<unsigned long long>(mixedSynced));
+    return stats.completeRounds > 0 ? 0 : 1;
+}
+
+const std::vector<Benchmark>& benchmarks()
+{
+    static const std::vector<Benchmark> list = {
+        {"online_filter", "加加速度受限设定点滤波器单周期耗时 (250us周期)", benchOnlineFilter},
+        {"cycle_jitter", "实时模式下1kHz周期唤醒延迟与超时次数", benchCycleJitter},
+        {"multirate", "4kHz节拍上的内环/1kHz轨迹/100Hz监控各自耗时与预算", benchMultiRate},
+        {"can_frame_ring", "vector+erase与环形缓冲+memchr两种CAN帧提取方式的吞吐 (帧/秒)", benchCanFrameRing},
+        {"spsc_handoff", "CAN记录交接：FIFO+互斥锁+条件变量与无锁SPSC队列 (逐条/批量) 的单条成本和吞吐", benchSpscHandoff},
+        {"can_rx_overflow", "CAN接收队列积压时三种溢出策略下解析线程发布的关节状态年龄与溢出计数", benchCanRxOverflow},
+        {"can_parser_batch", "CAN解析逐帧与批量取出/合并发布的吞吐和每帧CPU时间 (回放)", benchCanParserBatch},
+        {"trace_log", "每帧跟踪记录在调用处的耗时：级别关闭/二进制写入/当场格式化，及消费线程格式化耗时", benchTraceLog},
+        {"serial_rx", "select/忙轮询/阻塞读三种串口接收方式的延迟分布与CPU占用", benchSerialRx},
+        {"state_age", "关节状态经无锁交换区到达控制周期时的年龄", benchStateAge},
+        {"feedback_trigger", "定时触发与反馈触发控制周期的状态年龄对比", benchFeedbackTrigger},
+        {"feedback_sync", "按指令轮次同步的多关节反馈快照与缺失统计", benchFeedbackSync},
+        {"fused_pipeline", "伪终端回环上多线程流水线与融合流水线的状态帧到指令延迟", benchFusedPipeline},
+        {"virtual_clock", "虚拟时钟下周期定时器的确定性快于实时运行", benchVirtualClock},
+    };
+    return list;
+}
+
+} // namespace
+
+int runBenchmark(const std::string& name)
+{
+    for (const Benchmark& b : benchmarks()) {
+        if (name == b.name) {
+            return b.run();
+        }
+    }
+
+    std::printf("用法: --bench <名称>\n");
+    for (const Benchmark& b : benchmarks()) {
+        std::printf("  %-20s %s\n", b.name, b.description);
+    }
+    return name.empty() ? 0 : 2;
+}
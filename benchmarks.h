@@ -0,0 +1,13 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+
+/**
+ * @brief 运行命令行基准测试 (main中通过 --bench <名称> 调用，不创建界面)
+ * @param name 基准名称，为空或未知时列出全部基准
+ * @return 进程退出码：0 表示达标
+ */
+int runBenchmark(const std::string& name);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,97 @@
+#include "can_frame_codec.h"
+
+#include <cstring>
+#include <stdexcept>
+
+int CanFrameCodec::jointIndexForMotor(uint8_t motorId)
+{
+    if (motorId == 17) {
+        return 1;
+    } else if (motorId == 18) {
+        return 2;
+    } else if (motorId == 19) {
+        return 3;
+    }
+    return -1;
+}
+
+bool CanFrameCodec::decodeState(const uint8_t *frame, int64_t rxTimeNs, JointState &state)
+{
+    const int jointIndex = jointIndexForMotor(motorId(frame));
+    if (jointIndex < 0) {
+        return false;
+    }
+
+    float pos = decodeField(frame[8], frame[9], MotorField::Pos);
+    float vel = decodeField(frame[10], frame[11], MotorField::Vel);
+    if (jointIndex == 3) {
+        pos = -pos;
+        vel = -vel;
+    }
+    state = JointState(jointIndex, pos, vel, rxTimeNs);
+    return true;
+}
+
+float CanFrameCodec::decodeField(uint8_t high,
+                                 uint8_t low,
+                                 MotorField field)
+{
+    int intValue = 0;
+
+    switch (field)
+    {
+    case MotorField::Pos:
+    {
+        intValue = (static_cast<int>(high) << 8) | low;
+        return uintToFloat(intValue, -12.5f, 12.5f, 16);
+    }
+
+    case MotorField::Vel:
+    {
+        intValue = (static_cast<int>(high) << 4) | (low >> 4);
+        return uintToFloat(intValue, -30.0f, 30.0f, 12);
+    }
+
+    case MotorField::Torque:
+    {
+        intValue = ((high & 0x0F) << 8) | low;
+        return uintToFloat(intValue, -10.0f, 10.0f, 12);
+    }
+    }
+
+    throw std::invalid_argument("Unknown MotorField");
+}
+
+//将整数转化成浮点数
+float CanFrameCodec::uintToFloat(int x_int, float x_min, float x_max, int bits)
+{
+    float span = x_max - x_min;
+    float offset = x_min;
+    return ((float)x_int) * span / ((float)((1 << bits) - 1)) + offset;
+}
+
+void CanFrameCodec::encodePosVel(int jointIndex, float targetPos, float targetVel, CommandFrame &out)
+{
+    // 构造CAN帧（根据达妙电机协议）
+    int canId = (jointIndex == 3) ? 0x03 : jointIndex;
+    uint32_t canIdWithMode = canId + 0x100;  // 位置速度控制模式
+
+    static const uint8_t head[21] = {0x55, 0xaa, 0x1e, 0x01, 0x01, 0x00, 0x00, 0x00,
+                                     0x0a, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+                                     0x00, 0x00, 0x08, 0x00, 0x00};
+
+    out.fill(0);
+    std::memcpy(out.data(), head, sizeof(head));
+
+    // 写入CAN ID (little-endian)
+    out[13] = canIdWithMode & 0xFF;
+    out[14] = (canIdWithMode >> 8) & 0xFF;
+    out[15] = (canIdWithMode >> 16) & 0xFF;
+    out[16] = (canIdWithMode >> 24) & 0xFF;
+
+    // 写入位置（float）
+    std::memcpy(out.data() + 21, &targetPos, sizeof(float));
+
+    // 写入速度（float）
+    std::memcpy(out.data() + 25, &targetVel, sizeof(float));
+}
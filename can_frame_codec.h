@@ -0,0 +1,89 @@
+#ifndef CAN_FRAME_CODEC_H
+#define CAN_FRAME_CODEC_H
+
+#include "robot_common.h"
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief 串口CAN适配器的帧编解码 (无状态，可在任意线程调用)
+ *
+ * 接收：16字节帧 AA 11 08 ... 55，帧类型0x11为电机状态帧，0x12为ACK帧；
+ * 发送：30字节串口转CAN帧，位置速度模式的数据段为两个float。
+ */
+class CanFrameCodec
+{
+public:
+    static constexpr uint8_t kHead = 0xAA;
+    static constexpr uint8_t kTail = 0x55;
+    static constexpr size_t kFrameLength = 16;
+    static constexpr uint8_t kStatusFrame = 0x11;
+    static constexpr size_t kCommandLength = 30;
+
+    using Frame = std::array<uint8_t, kFrameLength>;
+    using CommandFrame = std::array<uint8_t, kCommandLength>;
+
+    // 从接收字节流中提取帧的结果 (见CanFrameRing::next)
+    enum class ExtractResult
+    {
+        GotFrame,
+        NeedMoreData,
+        NoFrame
+    };
+
+    enum class MotorField
+    {
+        Pos,
+        Vel,
+        Torque
+    };
+
+    /**
+     * @brief 帧数据既可以是Frame，也可以是指向接收缓冲区内16字节的指针 (CanFrameRing的帧视图)
+     */
+    static bool isStatusFrame(const uint8_t *frame) { return frame[1] == kStatusFrame; }
+    static bool isStatusFrame(const Frame &frame) { return isStatusFrame(frame.data()); }
+
+    /**
+     * @brief 电机CAN ID对应的关节号 (17-19 -> 1-3)，未知ID返回-1
+     */
+    static int jointIndexForMotor(uint8_t motorId);
+
+    /**
+     * @brief 解码状态帧为关节状态 (关节3方向取反)
+     * @param rxTimeNs 串口接收时刻
+     * @return 电机ID是否已知
+     */
+    static bool decodeState(const uint8_t *frame, int64_t rxTimeNs, JointState &state);
+    static bool decodeState(const Frame &frame, int64_t rxTimeNs, JointState &state)
+    {
+        return decodeState(frame.data(), rxTimeNs, state);
+    }
+
+    static uint8_t motorId(const uint8_t *frame) { return frame[7]; }
+    static uint8_t motorId(const Frame &frame) { return motorId(frame.data()); }
+
+    /**
+     * @brief 状态帧中的两个字节按字段的位宽和量程换算成物理量
+     */
+    static float decodeField(uint8_t high, uint8_t low, MotorField field);
+
+    /**
+     * @brief 编码位置速度模式指令 (CAN ID = 关节号 + 0x100)
+     */
+    static void encodePosVel(int jointIndex, float targetPos, float targetVel, CommandFrame &out);
+
+private:
+    static float uintToFloat(int x_int, float x_min, float x_max, int bits);
+};
+
+/**
+ * @brief CAN接收FIFO中的一条记录：16字节串口CAN帧 + 串口接收时刻
+ */
+struct CanRxRecord
+{
+    CanFrameCodec::Frame frame{};
+    int64_t rxTimeNs = 0;   // recv返回时的 Clock::now()
+};
+
+#endif // CAN_FRAME_CODEC_H
@@ -0,0 +1,81 @@
+#include "can_frame_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint8_t *CanFrameRing::writePtr()
+{
+    if (read_ == write_) {
+        read_ = write_ = 0;
+    } else if (read_ > 0 && writable() < kCapacity / 2) {
+        // 剩下的只是半帧或未取走的数据，整体前移
+        const size_t pending = write_ - read_;
+        std::memmove(buf_, buf_ + read_, pending);
+        read_ = 0;
+        write_ = pending;
+    }
+    return buf_ + write_;
+}
+
+void CanFrameRing::commit(size_t len)
+{
+    write_ += std::min(len, writable());
+}
+
+size_t CanFrameRing::append(const uint8_t *data, size_t len)
+{
+    uint8_t *dst = writePtr();
+    const size_t count = std::min(len, writable());
+    std::memcpy(dst, data, count);
+    write_ += count;
+    return count;
+}
+
+const uint8_t *CanFrameRing::findHead(size_t from) const
+{
+    if (from >= write_) {
+        return nullptr;
+    }
+    // glibc的memchr按字长/向量宽度扫描
+    return static_cast<const uint8_t *>(std::memchr(buf_ + from, CanFrameCodec::kHead, write_ - from));
+}
+
+CanFrameRing::ExtractResult CanFrameRing::next(View &view)
+{
+    if (read_ == write_) {
+        return ExtractResult::NeedMoreData;
+    }
+
+    const uint8_t *begin = buf_ + read_;
+    const uint8_t *head = findHead(read_);
+
+    // 帧头之前 (或没有帧头时全部) 是UART数据
+    if (head != begin) {
+        const uint8_t *end = head ? head : buf_ + write_;
+        view.data = begin;
+        view.size = static_cast<size_t>(end - begin);
+        read_ += view.size;
+        return ExtractResult::NoFrame;
+    }
+
+    // 帧不完整
+    if (write_ - read_ < CanFrameCodec::kFrameLength) {
+        return ExtractResult::NeedMoreData;
+    }
+
+    // 就地校验帧尾
+    if (begin[CanFrameCodec::kFrameLength - 1] == CanFrameCodec::kTail) {
+        view.data = begin;
+        view.size = CanFrameCodec::kFrameLength;
+        read_ += CanFrameCodec::kFrameLength;
+        return ExtractResult::GotFrame;
+    }
+
+    // 假帧头：直到下一个帧头的字节都不属于CAN帧
+    const uint8_t *nextHead = findHead(read_ + 1);
+    const uint8_t *end = nextHead ? nextHead : buf_ + write_;
+    view.data = begin;
+    view.size = static_cast<size_t>(end - begin);
+    read_ += view.size;
+    return ExtractResult::NoFrame;
+}
@@ -0,0 +1,65 @@
+#ifndef CAN_FRAME_RING_H
+#define CAN_FRAME_RING_H
+
+#include "can_frame_codec.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 串口字节流的定长环形缓冲与CAN帧提取 (单线程使用)
+ *
+ * 串口数据直接read进缓冲区 (writePtr/commit)，next()用memchr查找帧头、就地校验帧尾，
+ * 返回指向缓冲区内部的帧视图，不拷贝、不逐帧搬移数据。
+ * 读位置追上写位置时两者归零；写到缓冲区末端时只把剩余的未完成字节 (通常不足一帧) 移到开头。
+ */
+class CanFrameRing
+{
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    using ExtractResult = CanFrameCodec::ExtractResult;
+
+    /**
+     * @brief 缓冲区内一段连续字节，在下一次writePtr()/append()之前有效
+     */
+    struct View
+    {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+
+        uint8_t operator[](size_t i) const { return data[i]; }
+    };
+
+    /**
+     * @brief 可写区域的起点，写入后调用commit()；必要时先把未处理的字节移到缓冲区开头
+     */
+    uint8_t *writePtr();
+    size_t writable() const { return kCapacity - write_; }
+    void commit(size_t len);
+
+    /**
+     * @brief 拷贝写入，超出可写区域的部分丢弃
+     * @return 实际写入的字节数
+     */
+    size_t append(const uint8_t *data, size_t len);
+
+    /**
+     * @brief 取出下一段
+     *
+     * GotFrame：view为完整帧 (帧头帧尾已校验)；NoFrame：view为帧头之前的UART字节，
+     * 或帧尾不对的假帧头及其后直到下一个帧头的字节；NeedMoreData：缓冲区已空或只剩半帧。
+     */
+    ExtractResult next(View &view);
+
+    size_t size() const { return write_ - read_; }
+    void clear() { read_ = write_ = 0; }
+
+private:
+    const uint8_t *findHead(size_t from) const;
+
+    alignas(64) uint8_t buf_[kCapacity];
+    size_t read_ = 0;
+    size_t write_ = 0;
+};
+
+#endif // CAN_FRAME_RING_H
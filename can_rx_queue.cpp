@@ -0,0 +1,197 @@
+#include "can_rx_queue.h"
+#include "futex_wait.h"
+#include "monotonic_clock.h"
+
+namespace {
+
+// 单写者计数器：不需要原子读改写
+void bump(std::atomic<uint64_t>& counter, uint64_t delta = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+CanRxQueue::CanRxQueue(size_t capacity, OverflowPolicy policy)
+    : capacity_(capacity)
+    , policy_(policy)
+{
+    reset(policy);
+}
+
+void CanRxQueue::reset(OverflowPolicy policy)
+{
+    policy_ = policy;
+    // 唤醒由本类负责 (信箱写入也要唤醒)，队列本身不做等待者检查
+    ring_.reset(new SpscRing<CanRxRecord>(capacity_, false, policy == OverflowPolicy::DropOldest));
+    for (SeqLockSlot<Mail>& mailbox : mailboxes_) {
+        mailbox.store(Mail());
+    }
+    pending_.store(0);
+    mailSequence_ = 0;
+    taken_.fill(0);
+    nextMailbox_ = 0;
+    pushed_.store(0);
+    overflows_.store(0);
+    dropped_.store(0);
+    superseded_.store(0);
+    highWater_.store(0);
+}
+
+bool CanRxQueue::push(const CanRxRecord& record)
+{
+    bump(pushed_);
+
+    if (policy_ == OverflowPolicy::LatestValue) {
+        const int jointIndex = CanFrameCodec::jointIndexForMotor(CanFrameCodec::motorId(record.frame));
+        if (jointIndex >= 1 && jointIndex <= kMailboxes) {
+            Mail mail;
+            mail.record = record;
+            mail.sequence = ++mailSequence_;
+            mailboxes_[jointIndex - 1].store(mail);
+            const uint32_t bit = 1u << (jointIndex - 1);
+            if (pending_.fetch_or(bit, std::memory_order_acq_rel) & bit) {
+                bump(superseded_);
+            }
+            notePending();
+            signal();
+            return true;
+        }
+    }
+
+    bool accepted = true;
+    if (policy_ == OverflowPolicy::DropOldest) {
+        if (ring_->pushOverwrite(record)) {
+            bump(overflows_);
+            bump(dropped_);
+        }
+    } else if (!ring_->push(record)) {
+        bump(overflows_);
+        bump(dropped_);
+        accepted = false;
+    }
+    notePending();
+    signal();
+    return accepted;
+}
+
+size_t CanRxQueue::popBatch(CanRxRecord* out, size_t maxCount)
+{
+    size_t count = ring_->popBatch(out, maxCount);
+    if (policy_ != OverflowPolicy::LatestValue || count == maxCount) {
+        return count;
+    }
+
+    // 从上次之后的信箱开始轮转，取不完时各关节轮流被取，不会总是饿着编号大的关节
+    uint32_t bits = pending_.exchange(0, std::memory_order_acq_rel);
+    const int first = nextMailbox_;
+    for (int k = 0; k < kMailboxes && bits != 0; ++k) {
+        const int j = (first + k) % kMailboxes;
+        const uint32_t bit = 1u << j;
+        if (!(bits & bit)) {
+            continue;
+        }
+        bits &= ~bit;
+        if (count == maxCount) {
+            // 放不下的留到下次
+            pending_.fetch_or(bit, std::memory_order_acq_rel);
+            continue;
+        }
+        // 清位之后生产者可能又写入一次：读到的是更新的值，其位会再次置起，按序号去重
+        const Mail mail = mailboxes_[j].load();
+        if (mail.sequence != taken_[j]) {
+            taken_[j] = mail.sequence;
+            out[count++] = mail.record;
+            nextMailbox_ = (j + 1) % kMailboxes;
+        }
+    }
+    return count;
+}
+
+bool CanRxQueue::hasData() const
+{
+    return !ring_->empty() || pending_.load(std::memory_order_acquire) != 0;
+}
+
+void CanRxQueue::notePending()
+{
+    uint64_t occupancy = ring_->size();
+    if (policy_ == OverflowPolicy::LatestValue) {
+        occupancy += static_cast<uint64_t>(__builtin_popcount(pending_.load(std::memory_order_relaxed)));
+    }
+    if (occupancy > highWater_.load(std::memory_order_relaxed)) {
+        highWater_.store(occupancy, std::memory_order_relaxed);
+    }
+}
+
+// 写入数据 / 栅栏 / waiters读取 与消费者的 waiters++ / 栅栏 / 数据读取 配对，不会丢失唤醒
+void CanRxQueue::signal()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+        generation_.fetch_add(1);
+        futexWakeAll(&generation_);
+    }
+}
+
+bool CanRxQueue::waitForData(int64_t timeoutNs)
+{
+    if (hasData()) {
+        return true;
+    }
+    const uint32_t seen = generation_.load();
+    waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hasData()) {
+        futexWaitUntil(&generation_, seen, MonotonicClock().nowNs() + timeoutNs);
+    }
+    waiters_.fetch_sub(1);
+    return hasData();
+}
+
+void CanRxQueue::wakeConsumer()
+{
+    generation_.fetch_add(1);
+    futexWakeAll(&generation_);
+}
+
+CanRxQueue::Stats CanRxQueue::stats() const
+{
+    Stats stats;
+    stats.pushed = pushed_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.superseded = superseded_.load(std::memory_order_relaxed);
+    stats.highWater = highWater_.load(std::memory_order_relaxed);
+    stats.capacity = ring_->capacity();
+    return stats;
+}
+
+const char* CanRxQueue::policyName(OverflowPolicy policy)
+{
+    switch (policy) {
+    case OverflowPolicy::DropOldest:
+        return "drop-oldest";
+    case OverflowPolicy::LatestValue:
+        return "latest-value";
+    case OverflowPolicy::DropNewest:
+        break;
+    }
+    return "drop-newest";
+}
+
+void JointStateBatch::add(const CanRxRecord& record)
+{
+    JointState state;
+    if (!CanFrameCodec::decodeState(record.frame, record.rxTimeNs, state)) {
+        ++unknown;
+        lastUnknownMotor = CanFrameCodec::motorId(record.frame);
+        return;
+    }
+    ++decoded;
+    const uint32_t bit = 1u << (state.jointIndex - 1);
+    if (!(jointMask & bit) || state.timestampNs >= latest[state.jointIndex].timestampNs) {
+        latest[state.jointIndex] = state;
+        jointMask |= bit;
+    }
+}
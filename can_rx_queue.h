@@ -0,0 +1,142 @@
+#ifndef CAN_RX_QUEUE_H
+#define CAN_RX_QUEUE_H
+
+#include "can_frame_codec.h"
+#include "spsc_ring.h"
+#include "state_exchange.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief 串口接收线程 → CAN解析线程的记录队列 (单生产者单消费者，无锁)
+ *
+ * 队列满时按溢出策略处理，并统计溢出、丢弃和最高占用，用于按实测数据确定队列大小：
+ * - DropNewest：丢弃新记录 (原FIFO的行为)，积压时解析线程处理的状态越来越旧；
+ * - DropOldest：丢弃最旧的记录，保留最近capacity条；
+ * - LatestValue：关节1-3的状态帧写入各电机的最新值信箱，未取走的旧状态直接被新状态取代，
+ *   永不溢出；其他记录 (未知电机ID) 仍走队列，满时丢弃新记录。
+ */
+class CanRxQueue
+{
+public:
+    enum class OverflowPolicy
+    {
+        DropNewest,
+        DropOldest,
+        LatestValue
+    };
+
+    struct Stats
+    {
+        uint64_t pushed = 0;       // 写入的记录
+        uint64_t overflows = 0;    // 写入时队列已满的次数
+        uint64_t dropped = 0;      // 因溢出丢弃的记录 (最新或最旧)
+        uint64_t superseded = 0;   // LatestValue：未被取走就被同一电机新状态取代的记录
+        uint64_t highWater = 0;    // 待取记录数的最大值
+        uint64_t capacity = 0;
+    };
+
+    explicit CanRxQueue(size_t capacity = 256, OverflowPolicy policy = OverflowPolicy::DropNewest);
+
+    /**
+     * @brief 清空队列和统计并切换溢出策略 (只能在生产者和消费者线程都未运行时调用)
+     */
+    void reset(OverflowPolicy policy);
+
+    OverflowPolicy policy() const { return policy_; }
+
+    /**
+     * @brief 写入一条记录 (仅生产者线程)，消费者休眠时唤醒
+     * @return 记录是否进入队列 (DropNewest溢出时为false)
+     */
+    bool push(const CanRxRecord& record);
+
+    /**
+     * @brief 取出最多maxCount条记录 (仅消费者线程)：先取队列，再取有新状态的信箱
+     */
+    size_t popBatch(CanRxRecord* out, size_t maxCount);
+    bool pop(CanRxRecord& out) { return popBatch(&out, 1) == 1; }
+
+    /**
+     * @brief 没有待取记录时休眠，直到写入、wakeConsumer()或超时 (仅消费者线程)
+     * @return 返回时是否有待取记录
+     */
+    bool waitForData(int64_t timeoutNs);
+
+    /**
+     * @brief 让阻塞在waitForData中的消费者返回 (任意线程)
+     */
+    void wakeConsumer();
+
+    /**
+     * @brief 统计快照 (任意线程)
+     */
+    Stats stats() const;
+
+    static const char* policyName(OverflowPolicy policy);
+
+private:
+    static constexpr int kMailboxes = JointStateExchange::kJointCount;
+
+    // 信箱内容：记录 + 写入序号，消费者按序号去重
+    struct Mail
+    {
+        CanRxRecord record;
+        uint64_t sequence = 0;
+    };
+
+    bool hasData() const;
+    void notePending();
+    void signal();
+
+    const size_t capacity_;
+    OverflowPolicy policy_;
+    std::unique_ptr<SpscRing<CanRxRecord>> ring_;
+
+    std::array<SeqLockSlot<Mail>, kMailboxes> mailboxes_;
+    alignas(64) std::atomic<uint32_t> pending_{0};   // 有未取新状态的信箱位掩码
+    uint64_t mailSequence_ = 0;                      // 生产者
+    std::array<uint64_t, kMailboxes> taken_{};       // 消费者：各信箱已取走的序号
+    int nextMailbox_ = 0;                            // 消费者：下次最先查看的信箱
+
+    // 统计：只有生产者写
+    alignas(64) std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> superseded_{0};
+    std::atomic<uint64_t> highWater_{0};
+
+    alignas(64) std::atomic<uint32_t> generation_{0};   // futex字：唤醒时加1
+    std::atomic<uint32_t> waiters_{0};
+};
+
+/**
+ * @brief 一批CAN记录的解码结果：每个关节只保留最新的状态，整批处理完后每个关节发布一次
+ */
+struct JointStateBatch
+{
+    std::array<JointState, JointStateExchange::kJointCount + 1> latest{};   // 下标为关节号
+    uint32_t jointMask = 0;      // 位j-1：关节j在本批中有新状态
+    int decoded = 0;             // 本批解码出的状态帧
+    int unknown = 0;             // 未知电机ID的帧
+    uint8_t lastUnknownMotor = 0;
+
+    void clear()
+    {
+        jointMask = 0;
+        decoded = 0;
+        unknown = 0;
+    }
+
+    /**
+     * @brief 解码一条记录，同一关节接收时刻较新的状态覆盖较旧的
+     */
+    void add(const CanRxRecord& record);
+
+    bool has(int jointIndex) const { return (jointMask >> (jointIndex - 1)) & 1u; }
+};
+
+#endif // CAN_RX_QUEUE_H
@@ -0,0 +1,78 @@
+#include "fused_serial_io.h"
+#include "monotonic_clock.h"
+
+#include <algorithm>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+FusedSerialIo::FusedSerialIo(int fd, JointStateExchange &exchange, FeedbackAssembler *assembler)
+    : fd_(fd)
+    , exchange_(exchange)
+    , assembler_(assembler)
+{
+}
+
+int FusedSerialIo::poll(int64_t deadlineNs)
+{
+    const int64_t waitNs = std::max<int64_t>(0, deadlineNs - Clock::now());
+    timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(waitNs / Clock::kNsPerSec);
+    timeout.tv_nsec = static_cast<long>(waitNs % Clock::kNsPerSec);
+    pollfd pfd{fd_, POLLIN, 0};
+    if (ppoll(&pfd, 1, &timeout, nullptr) <= 0 || !(pfd.revents & POLLIN)) {
+        return 0;
+    }
+
+    int published = 0;
+    while (true) {
+        uint8_t *recvPtr = ring_.writePtr();
+        const size_t room = ring_.writable();
+        const ssize_t recvLen = ::read(fd_, recvPtr, room);
+        if (recvLen <= 0) {
+            break;
+        }
+        // 本次读到的数据中完成的帧都以此刻为接收时间
+        const int64_t rxTimeNs = Clock::now();
+        ++stats_.reads;
+        ring_.commit(static_cast<size_t>(recvLen));
+
+        CanFrameRing::View view;
+        CanFrameCodec::ExtractResult result;
+        while ((result = ring_.next(view)) != CanFrameCodec::ExtractResult::NeedMoreData) {
+            if (result == CanFrameCodec::ExtractResult::GotFrame) {
+                JointState state;
+                if (CanFrameCodec::isStatusFrame(view.data) && CanFrameCodec::decodeState(view.data, rxTimeNs, state)) {
+                    exchange_.publish(state);
+                    if (assembler_) {
+                        assembler_->publish(state);
+                    }
+                    ++stats_.frames;
+                    ++published;
+                } else {
+                    ++stats_.otherFrames;
+                }
+            } else {
+                // 帧头之前 (或没有帧头时全部) 的字节不属于CAN帧
+                stats_.droppedBytes += view.size;
+            }
+        }
+
+        if (static_cast<size_t>(recvLen) < room) {
+            break;
+        }
+    }
+    return published;
+}
+
+bool FusedSerialIo::sendCommand(int jointIndex, float targetPos, float targetVel)
+{
+    CanFrameCodec::CommandFrame frame;
+    CanFrameCodec::encodePosVel(jointIndex, targetPos, targetVel, frame);
+    if (::write(fd_, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size())) {
+        ++stats_.writeErrors;
+        return false;
+    }
+    ++stats_.commands;
+    return true;
+}
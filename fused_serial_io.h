@@ -0,0 +1,56 @@
+#ifndef FUSED_SERIAL_IO_H
+#define FUSED_SERIAL_IO_H
+
+#include "can_frame_codec.h"
+#include "can_frame_ring.h"
+#include "state_exchange.h"
+#include <cstdint>
+
+/**
+ * @brief 融合流水线的串口收发 (run-to-completion)
+ *
+ * 在调用线程 (控制线程) 内直接完成 读串口 → 提取帧 → 解码 → 发布状态，
+ * 以及指令的编码和写出，不经过接收线程、FIFO和解析线程。
+ * 使用期间串口不能再有其他读者；帧头之外的UART字节直接丢弃并计数。
+ */
+class FusedSerialIo
+{
+public:
+    struct Stats
+    {
+        uint64_t reads = 0;           // 读到数据的read次数
+        uint64_t frames = 0;          // 发布的状态帧
+        uint64_t otherFrames = 0;     // ACK等非状态帧及未知电机ID的帧
+        uint64_t droppedBytes = 0;    // 帧外的字节
+        uint64_t commands = 0;        // 写出的指令帧
+        uint64_t writeErrors = 0;
+    };
+
+    /**
+     * @param fd 串口文件描述符 (VMIN=0/VTIME=0或非阻塞，读空时立即返回)
+     * @param assembler 可为空；非空时状态帧同时按指令轮次组装
+     */
+    FusedSerialIo(int fd, JointStateExchange &exchange, FeedbackAssembler *assembler = nullptr);
+
+    /**
+     * @brief 等待串口数据直到绝对时刻deadlineNs (已过则不等待)，读出已到达的全部字节并发布其中的状态帧
+     * @return 本次发布的状态帧数
+     */
+    int poll(int64_t deadlineNs);
+
+    /**
+     * @brief 编码并写出一个关节的位置速度指令
+     */
+    bool sendCommand(int jointIndex, float targetPos, float targetVel);
+
+    const Stats &stats() const { return stats_; }
+
+private:
+    int fd_;
+    JointStateExchange &exchange_;
+    FeedbackAssembler *assembler_;
+    CanFrameRing ring_;
+    Stats stats_;
+};
+
+#endif // FUSED_SERIAL_IO_H
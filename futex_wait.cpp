@@ -0,0 +1,24 @@
+#include "futex_wait.h"
+#include "monotonic_clock.h"
+
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// FUTEX_WAIT_BITSET 的超时为CLOCK_MONOTONIC绝对时刻，与 MonotonicClock 同一时基
+void futexWaitUntil(const std::atomic<uint32_t>* word, uint32_t expected, int64_t deadlineNs)
+{
+    timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(deadlineNs / Clock::kNsPerSec);
+    deadline.tv_nsec = static_cast<long>(deadlineNs % Clock::kNsPerSec);
+    syscall(SYS_futex, reinterpret_cast<const uint32_t*>(word), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG,
+            expected, &deadline, nullptr, FUTEX_BITSET_MATCH_ANY);
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX,
+            nullptr, nullptr, 0);
+}
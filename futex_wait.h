@@ -0,0 +1,23 @@
+#ifndef FUTEX_WAIT_H
+#define FUTEX_WAIT_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 进程内私有futex的等待与唤醒 (无锁结构的阻塞等待)
+ *
+ * 等待可能虚假返回，调用者需重新检查条件。
+ */
+
+/**
+ * @brief *word仍等于expected时休眠，直到被唤醒或到达CLOCK_MONOTONIC绝对时刻deadlineNs
+ */
+void futexWaitUntil(const std::atomic<uint32_t>* word, uint32_t expected, int64_t deadlineNs);
+
+/**
+ * @brief 唤醒在word上等待的全部线程
+ */
+void futexWakeAll(std::atomic<uint32_t>* word);
+
+#endif // FUTEX_WAIT_H
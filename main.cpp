@@ -1,9 +1,16 @@
 #include "mainwindow.h"
+#include "benchmarks.h"
 
 #include <QApplication>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // 基准测试：--bench <名称>，不创建界面
+    if (argc >= 2 && std::strcmp(argv[1], "--bench") == 0) {
+        return runBenchmark(argc >= 3 ? argv[2] : "");
+    }
+
     QApplication app(argc, argv);
     MainWindow w;
     w.show();
@@ -59,7 +59,7 @@ QGroupBox *MainWindow::buildConnectionPanel()
     auto *layout = new QGridLayout(group);
     layout->setHorizontalSpacing(12);
     layout->setVerticalSpacing(8);
-    layout->setRowStretch(6, 1);
+    layout->setRowStretch(9, 1);
     layout->setAlignment(Qt::AlignTop);
 
     auto *portLabel = new QLabel(QStringLiteral("串口号:"));
@@ -79,6 +79,25 @@ QGroupBox *MainWindow::buildConnectionPanel()
     timeoutCombo_ = new QComboBox;
     timeoutCombo_->addItems({"2", "10", "50", "100"});
 
+    // 串口接收方式：select (省CPU) / 忙轮询 (最低延迟，占一个核) / 阻塞读 (按帧长VMIN)
+    rxModeCombo_ = new QComboBox;
+    rxModeCombo_->addItems({QStringLiteral("select"), QStringLiteral("busy-poll"), QStringLiteral("blocking")});
+
+    // CAN接收队列满时的处理：只保留各电机最新状态 / 丢弃最旧 / 丢弃最新
+    auto *overflowLabel = new QLabel(QStringLiteral("CAN队列溢出:"));
+    overflowCombo_ = new QComboBox;
+    overflowCombo_->addItems({QStringLiteral("latest-value"), QStringLiteral("drop-oldest"), QStringLiteral("drop-newest")});
+
+    // 跟踪日志级别：debug时记录每个CAN帧和被过滤的ACK帧
+    auto *traceLabel = new QLabel(QStringLiteral("跟踪级别:"));
+    traceLevelCombo_ = new QComboBox;
+    traceLevelCombo_->addItems({QStringLiteral("info"), QStringLiteral("debug"), QStringLiteral("off")});
+
+    // 控制流水线：threaded为接收/解析/控制各自一个线程；fused由控制线程直接收发串口 (解码→控制→编码)
+    auto *pipelineLabel = new QLabel(QStringLiteral("控制流水线:"));
+    pipelineCombo_ = new QComboBox;
+    pipelineCombo_->addItems({QStringLiteral("threaded"), QStringLiteral("fused")});
+
     openBtn_ = new QPushButton(QStringLiteral("打开串口"));
     refreshBtn_ = new QPushButton(QStringLiteral("刷新设备"));
     enableBtn_ = new QPushButton(QStringLiteral("使能电机"));
@@ -98,6 +117,16 @@ QGroupBox *MainWindow::buildConnectionPanel()
     layout->addWidget(disableBtn_, 4, 1);
 
     layout->addWidget(timeoutCombo_, 5, 0);
+    layout->addWidget(rxModeCombo_, 5, 1);
+
+    layout->addWidget(overflowLabel, 6, 0);
+    layout->addWidget(overflowCombo_, 6, 1);
+
+    layout->addWidget(traceLabel, 7, 0);
+    layout->addWidget(traceLevelCombo_, 7, 1);
+
+    layout->addWidget(pipelineLabel, 8, 0);
+    layout->addWidget(pipelineCombo_, 8, 1);
 
     return group;
 }
@@ -273,6 +302,33 @@ MainWindow::MainWindow(QWidget *parent)
     connect(robotController_, &RobotController::controlStatusChanged, this, &MainWindow::onControlStatusChanged);
     connect(robotController_, &RobotController::logMessage, this, &MainWindow::appendLog);
 
+    // 跟踪日志：低优先级线程按批格式化，整批排队追加到日志框
+    connect(traceLevelCombo_, &QComboBox::currentTextChanged, this, [](const QString &text) {
+        if (text == QStringLiteral("debug")) {
+            TraceLog::setLevel(TraceLevel::Debug);
+        } else if (text == QStringLiteral("off")) {
+            TraceLog::setLevel(TraceLevel::Off);
+        } else {
+            TraceLog::setLevel(TraceLevel::Info);
+        }
+    });
+    TraceLog::setLevel(TraceLevel::Info);
+
+    // 流水线模式在下次运行算法时生效，运行中不可切换
+    connect(pipelineCombo_, &QComboBox::currentTextChanged, this, [this](const QString &text) {
+        controlParams_.fusedPipeline = text == QStringLiteral("fused");
+        if (robotController_) {
+            robotController_->setControlParams(controlParams_);
+        }
+        appendLog(QStringLiteral("控制流水线: %1").arg(text));
+    });
+
+    TraceLog::instance().setSink([this](const std::string &lines) {
+        const QString text = QString::fromStdString(lines);
+        QMetaObject::invokeMethod(this, [this, text]() { appendLog(text); }, Qt::QueuedConnection);
+    });
+    TraceLog::instance().start();
+
     this->onRefreshDevicesClicked();
 }
 
@@ -282,6 +338,9 @@ MainWindow::~MainWindow()
     if (robotController_) {
         robotController_->stopControl();
     }
+    // 输出回调引用了本窗口，先停止消费线程再清除
+    TraceLog::instance().stop();
+    TraceLog::instance().setSink(nullptr);
     delete serialPort_;
     serialPort_ = nullptr;
 }
@@ -332,9 +391,22 @@ void MainWindow::onOpenSerialClicked()
                   .arg(timeoutMs));
 
     serialPort_ = new SerialPort(port.toStdString(), baudrate, timeoutMs);
+    applyRxMode();
     startWorkers();
 }
 
+void MainWindow::applyRxMode()
+{
+    const QString rxMode = rxModeCombo_ ? rxModeCombo_->currentText() : QStringLiteral("select");
+    if (rxMode == QStringLiteral("busy-poll")) {
+        serialPort_->set_rx_mode(SerialPort::RxMode::BusyPoll);
+    } else if (rxMode == QStringLiteral("blocking")) {
+        serialPort_->set_rx_mode(SerialPort::RxMode::Blocking, false, static_cast<int>(CanFrameCodec::kFrameLength));
+    } else {
+        serialPort_->set_rx_mode(SerialPort::RxMode::Select);
+    }
+}
+
 void MainWindow::onRefreshDevicesClicked()
 {
     if (!portCombo_) return;
@@ -390,12 +462,21 @@ void MainWindow::startWorkers()
         return;
     }
 
+    // 线程启动前切换溢出策略并清空上次残留的记录
+    const QString overflow = overflowCombo_ ? overflowCombo_->currentText() : QStringLiteral("drop-newest");
+    if (overflow == QStringLiteral("latest-value")) {
+        canRxQueue_.reset(CanRxQueue::OverflowPolicy::LatestValue);
+    } else if (overflow == QStringLiteral("drop-oldest")) {
+        canRxQueue_.reset(CanRxQueue::OverflowPolicy::DropOldest);
+    } else {
+        canRxQueue_.reset(CanRxQueue::OverflowPolicy::DropNewest);
+    }
+
     serialThread_ = new QThread(this);
     canParserThread_ = new QThread(this);
 
-    serialRxWorker_ = new SerialRxWorker(serialPort_, &canRxFifo_, &uartRxFifo_,
-                                         &canRxMutex_, &uartRxMutex_, &canDataReady_);
-    canParserWorker_ = new CanParserWorker(&canRxFifo_, &canRxMutex_, &canDataReady_);
+    serialRxWorker_ = new SerialRxWorker(serialPort_, &canRxQueue_, &uartRxQueue_);
+    canParserWorker_ = new CanParserWorker(&canRxQueue_);
     //决定这个 QObject 的槽函数将在哪个线程执行,此处表示将serialRxWorker_中的所有槽函数的执行权转移到serialThread_线程中
     serialRxWorker_->moveToThread(serialThread_);
     canParserWorker_->moveToThread(canParserThread_);
@@ -405,8 +486,9 @@ void MainWindow::startWorkers()
 
     connect(serialRxWorker_, &SerialRxWorker::logMessage, this, &MainWindow::appendLog);
     connect(canParserWorker_, &CanParserWorker::logMessage, this, &MainWindow::appendLog);
+    // 直连：在解析线程中直接写入状态交换区，不经过主线程事件循环
     connect(canParserWorker_, &CanParserWorker::jointStateUpdated,
-            robotController_, &RobotController::updateJointState);
+            robotController_, &RobotController::updateJointState, Qt::DirectConnection);
 
             
     connect(serialThread_, &QThread::finished, serialRxWorker_, &QObject::deleteLater);
@@ -430,12 +512,10 @@ void MainWindow::stopWorkers()
         serialRxWorker_->stop();
     }
     if (canParserWorker_) {
+        // 同时唤醒可能在队列上休眠的解析线程
         canParserWorker_->stop();
     }
 
-    // 唤醒可能阻塞在条件变量上的消费者线程
-    canDataReady_.wakeAll();
-
     if (serialThread_) {
         serialThread_->quit();
         serialThread_->wait();
@@ -485,6 +565,14 @@ void MainWindow::onTeachClicked()
 void MainWindow::onRunAlgoClicked()
 {
     if(robotController_) {
+        // 融合流水线由控制线程直接读串口，先停掉接收和解析线程，停止控制后再恢复
+        if (controlParams_.fusedPipeline && serialPort_) {
+            stopWorkers();
+            // 控制线程内的read必须读空即返回 (VMIN=0/VTIME=0)，阻塞接收的VMIN/VTIME会让它卡住一个字节间隔
+            serialPort_->set_rx_mode(SerialPort::RxMode::Select);
+            appendLog(QStringLiteral("融合流水线：串口接收和CAN解析线程已暂停"));
+        }
+        pipelineCombo_->setEnabled(false);
         robotController_->startControl();
         appendLog(QStringLiteral("控制算法已启动"));
     }
@@ -513,6 +601,14 @@ void MainWindow::onControlStatusChanged(bool running)
 {
     QString status = running ? QStringLiteral("运行中") : QStringLiteral("已停止");
     appendLog(QStringLiteral("控制状态: %1").arg(status));
+
+    if (!running) {
+        pipelineCombo_->setEnabled(true);
+    }
+    if (!running && controlParams_.fusedPipeline && serialPort_) {
+        applyRxMode();  // 恢复用户选择的接收方式
+        startWorkers();
+    }
 }
 
 void MainWindow::adjustParameter(int index, float delta)
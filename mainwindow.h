@@ -1,12 +1,12 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
-#include "FIFO.h"
+#include "can_frame_codec.h"
+#include "can_rx_queue.h"
 #include "robot_common.h"
+#include "spsc_ring.h"
 
 #include <QMainWindow>
-#include <QMutex>
-#include <QWaitCondition>
 
 // 前向声明
 class JointState;
@@ -55,6 +55,7 @@ private:
 
     void startWorkers();
     void stopWorkers();
+    void applyRxMode();  // 按界面选择设置串口接收方式
     void appendLog(const QString &text);
 
     void EnableMotor();
@@ -74,6 +75,10 @@ private:
     QComboBox *parityCombo_ = nullptr;
     QComboBox *dataBitsCombo_ = nullptr;
     QComboBox *timeoutCombo_ = nullptr;
+    QComboBox *rxModeCombo_ = nullptr;
+    QComboBox *overflowCombo_ = nullptr;
+    QComboBox *traceLevelCombo_ = nullptr;
+    QComboBox *pipelineCombo_ = nullptr;
 
     QPushButton *openBtn_ = nullptr;
     QPushButton *refreshBtn_ = nullptr;
@@ -87,11 +92,8 @@ private:
     QPushButton *runAlgoBtn_ = nullptr;
     QSpinBox *secondsBox_ = nullptr;
 
-    FIFO canRxFifo_{4096};
-    FIFO uartRxFifo_{4096};
-    QMutex canRxMutex_;
-    QMutex uartRxMutex_;
-    QWaitCondition canDataReady_;
+    CanRxQueue canRxQueue_{256};                   // 串口接收线程 → CAN解析线程
+    SpscRing<uint8_t> uartRxQueue_{4096, false};   // 帧外的UART字节 (暂无消费者，满后丢弃)
 
     SerialPort *serialPort_ = nullptr;
     QThread *serialThread_ = nullptr;
@@ -0,0 +1,41 @@
+#include "monotonic_clock.h"
+
+#include <cerrno>
+#include <time.h>
+
+std::atomic<Clock*> Clock::installed_{nullptr};
+
+Clock& Clock::instance()
+{
+    static MonotonicClock monotonic;
+    Clock* clock = installed_.load(std::memory_order_acquire);
+    return clock ? *clock : monotonic;
+}
+
+void Clock::install(Clock* clock)
+{
+    installed_.store(clock, std::memory_order_release);
+}
+
+int64_t MonotonicClock::nowNs() const
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * kNsPerSec + ts.tv_nsec;
+}
+
+void MonotonicClock::sleepUntil(int64_t deadlineNs)
+{
+    timespec wake;
+    wake.tv_sec = static_cast<time_t>(deadlineNs / kNsPerSec);
+    wake.tv_nsec = static_cast<long>(deadlineNs % kNsPerSec);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {
+    }
+}
+
+void VirtualClock::advanceTo(int64_t timeNs)
+{
+    int64_t current = now_.load(std::memory_order_acquire);
+    while (current < timeNs && !now_.compare_exchange_weak(current, timeNs, std::memory_order_acq_rel)) {
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef MONOTONIC_CLOCK_H
+#define MONOTONIC_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 全流水线统一时基：单调递增的int64纳秒
+ *
+ * 串口接收时间戳、CAN解析、控制周期、发送和遥测都从 Clock::now() 取时间，
+ * 不受系统时间调整影响，也没有float在大数值下的精度问题。
+ * 默认实现为CLOCK_MONOTONIC；测试或离线仿真时可用 Clock::install()
+ * 换成 VirtualClock，sleepUntil直接推进虚拟时间，以确定性方式快于实时运行。
+ */
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    /**
+     * @brief 当前时刻 (纳秒，起点任意但单调)
+     */
+    virtual int64_t nowNs() const = 0;
+
+    /**
+     * @brief 阻塞到绝对时刻deadlineNs (已过则立即返回)
+     */
+    virtual void sleepUntil(int64_t deadlineNs) = 0;
+
+    /**
+     * @brief 是否为虚拟时钟 (与真实时间无关，不能用内核定时等待)
+     */
+    virtual bool isVirtual() const { return false; }
+
+    /**
+     * @brief 当前安装的时钟 (默认为单调时钟)
+     */
+    static Clock& instance();
+
+    /**
+     * @brief 安装全局时钟，传nullptr恢复默认单调时钟 (调用者保证clock的生命周期)
+     */
+    static void install(Clock* clock);
+
+    static int64_t now() { return instance().nowNs(); }
+
+    static constexpr int64_t kNsPerMs = 1000000;
+    static constexpr int64_t kNsPerSec = 1000000000;
+
+    static double toSeconds(int64_t ns) { return static_cast<double>(ns) * 1e-9; }
+    static int64_t fromSeconds(double seconds) { return static_cast<int64_t>(seconds * 1e9); }
+
+private:
+    static std::atomic<Clock*> installed_;
+};
+
+/**
+ * @brief CLOCK_MONOTONIC + clock_nanosleep(TIMER_ABSTIME)
+ */
+class MonotonicClock : public Clock
+{
+public:
+    int64_t nowNs() const override;
+    void sleepUntil(int64_t deadlineNs) override;
+};
+
+/**
+ * @brief 手动推进的虚拟时钟 (线程安全)
+ *
+ * sleepUntil不真正休眠，只把时间推进到deadline，多线程下时间只进不退。
+ */
+class VirtualClock : public Clock
+{
+public:
+    explicit VirtualClock(int64_t startNs = 0) : now_(startNs) {}
+
+    int64_t nowNs() const override { return now_.load(std::memory_order_acquire); }
+    void sleepUntil(int64_t deadlineNs) override { advanceTo(deadlineNs); }
+    bool isVirtual() const override { return true; }
+
+    void advance(int64_t deltaNs) { now_.fetch_add(deltaNs, std::memory_order_acq_rel); }
+    void advanceTo(int64_t timeNs);
+
+private:
+    std::atomic<int64_t> now_;
+};
+
+#endif // MONOTONIC_CLOCK_H
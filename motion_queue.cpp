@@ -0,0 +1,421 @@
+#include "motion_queue.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kMinLength = 1e-6f;        // 短于此的段视为无效
+constexpr int kSplineSamplesPerSegment = 64;
+
+// 由曲率κ限制的速度：向心加速度 v²κ 不超过 a
+float curvatureSpeed(float accel, float curvature)
+{
+    return curvature > 1e-9f ? std::sqrt(accel / curvature) : 1e9f;
+}
+
+} // namespace
+
+MotionSegment MotionSegment::line(const Vector3f& end, float feedrate)
+{
+    MotionSegment s;
+    s.type = Type::Line;
+    s.end = end;
+    s.feedrate = feedrate;
+    return s;
+}
+
+MotionSegment MotionSegment::arc(const Vector3f& center, const Vector3f& end, const Vector3f& axis, float feedrate)
+{
+    MotionSegment s;
+    s.type = Type::Arc;
+    s.center = center;
+    s.end = end;
+    s.axis = axis;
+    s.feedrate = feedrate;
+    return s;
+}
+
+MotionSegment MotionSegment::spiral(const Vector3f& center, float turns, float pitch, float feedrate)
+{
+    MotionSegment s;
+    s.type = Type::Spiral;
+    s.center = center;
+    s.turns = turns;
+    s.pitch = pitch;
+    s.feedrate = feedrate;
+    return s;
+}
+
+MotionSegment MotionSegment::spline(const std::vector<Vector3f>& waypoints, SplineKind kind, float feedrate)
+{
+    MotionSegment s;
+    s.type = Type::Spline;
+    s.waypoints = waypoints;
+    s.splineKind = kind;
+    s.feedrate = feedrate;
+    return s;
+}
+
+MotionQueue::MotionQueue(const Limits& limits)
+    : limits_(limits)
+{
+}
+
+void MotionQueue::reset(const Vector3f& startPosition)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocks_.clear();
+    position_ = startPosition;
+    queueEnd_ = startPosition;
+    progress_ = 0.0f;
+    speed_ = 0.0f;
+}
+
+bool MotionQueue::buildBlock(const MotionSegment& segment, const Vector3f& start, Block& block) const
+{
+    block.segment = segment;
+    block.type = segment.type;
+    block.start = start;
+    const float accel = limits_.maxAcceleration;
+    float speedLimit = std::min(segment.feedrate, limits_.maxFeedrate);
+
+    switch (segment.type) {
+    case MotionSegment::Type::Line: {
+        const Vector3f delta = segment.end - start;
+        block.length = delta.norm();
+        if (block.length < kMinLength) {
+            return false;
+        }
+        block.end = segment.end;
+        block.direction = delta / block.length;
+        block.startTangent = block.direction;
+        block.endTangent = block.direction;
+        break;
+    }
+    case MotionSegment::Type::Arc:
+    case MotionSegment::Type::Spiral: {
+        if (segment.axis.norm() < kMinLength) {
+            return false;
+        }
+        block.axis = segment.axis.normalized();
+        // 圆心取起点在轴线上的投影，起点径向为radialU
+        const Vector3f fromCenter = start - segment.center;
+        block.center = segment.center + block.axis * block.axis.dot(fromCenter);
+        const Vector3f radial = start - block.center;
+        block.radius = radial.norm();
+        if (block.radius < kMinLength) {
+            return false;
+        }
+        block.radialU = radial / block.radius;
+        block.radialV = block.axis.cross(block.radialU);
+
+        if (segment.type == MotionSegment::Type::Arc) {
+            const Vector3f endRel = segment.end - block.center;
+            const float endAxial = block.axis.dot(endRel);
+            const Vector3f endRadial = endRel - block.axis * endAxial;
+            if (std::abs(endRadial.norm() - block.radius) > 0.01f * block.radius + 1e-5f) {
+                return false;  // 起止点不在同一圆柱面上
+            }
+            float angle = std::atan2(endRadial.dot(block.radialV), endRadial.dot(block.radialU));
+            if (angle <= 1e-6f) {
+                angle += 2.0f * static_cast<float>(M_PI);  // 逆时针，起止重合时为整圆
+            }
+            block.sweep = angle;
+            block.rise = endAxial;
+        } else {
+            if (!(segment.turns > 0.0f)) {
+                return false;
+            }
+            block.sweep = 2.0f * static_cast<float>(M_PI) * segment.turns;
+            block.rise = segment.pitch * segment.turns;
+        }
+
+        const float arc = block.radius * block.sweep;
+        block.length = std::sqrt(arc * arc + block.rise * block.rise);
+        block.end = block.center + block.radius * (std::cos(block.sweep) * block.radialU +
+                                                   std::sin(block.sweep) * block.radialV) +
+                    block.axis * block.rise;
+        block.startTangent = (arc * block.radialV + block.rise * block.axis) / block.length;
+        block.endTangent = (arc * (-std::sin(block.sweep) * block.radialU + std::cos(block.sweep) * block.radialV) +
+                            block.rise * block.axis) / block.length;
+
+        // 螺旋线曲率 r / (r² + c²)，c为每弧度上升量
+        const float c = block.rise / block.sweep;
+        speedLimit = std::min(speedLimit, curvatureSpeed(accel, block.radius / (block.radius * block.radius + c * c)));
+        break;
+    }
+    case MotionSegment::Type::Spline: {
+        if (segment.waypoints.empty()) {
+            return false;
+        }
+        // 以弦长为节点时刻，样条参数近似弧长
+        std::vector<Vector3f> points;
+        std::vector<float> times;
+        points.reserve(segment.waypoints.size() + 1);
+        points.push_back(start);
+        times.push_back(0.0f);
+        for (const Vector3f& p : segment.waypoints) {
+            const float chord = (p - points.back()).norm();
+            if (chord < kMinLength) {
+                continue;
+            }
+            times.push_back(times.back() + chord);
+            points.push_back(p);
+        }
+        if (points.size() < 2 || !block.spline.build(points, times, segment.splineKind)) {
+            return false;
+        }
+
+        // 曲率采样求向心加速度限速；弧长表由ArcLengthPath建立 (曲线按值捕获样条，块可安全移动)
+        const int samples = kSplineSamplesPerSegment * static_cast<int>(points.size() - 1);
+        const float sampleStep = times.back() / samples;
+        float maxCurvature = 0.0f;
+        for (int k = 0; k <= samples; ++k) {
+            const TrajectoryPoint p = block.spline.evaluate(k * sampleStep);
+            const float speed = p.velocity.norm();
+            if (speed > 1e-6f) {
+                maxCurvature = std::max(maxCurvature, p.velocity.cross(p.acceleration).norm() / (speed * speed * speed));
+            }
+        }
+        const SplineTrajectory spline = block.spline;
+        const ArcLengthPath::Curve curve = [spline](float u) { return spline.evaluate(u).position; };
+        if (!block.path.build(curve, 0.0f, times.back(), samples) || block.path.length() < kMinLength) {
+            return false;
+        }
+        block.length = block.path.length();
+        block.end = points.back();
+        // 端点速度为0，切向取相邻采样点的方向
+        block.startTangent = (block.spline.evaluate(sampleStep).position - start).normalized();
+        block.endTangent = (block.end - block.spline.evaluate(times.back() - sampleStep).position).normalized();
+        speedLimit = std::min(speedLimit, curvatureSpeed(accel, maxCurvature));
+        break;
+    }
+    }
+
+    if (!(speedLimit > 0.0f)) {
+        return false;
+    }
+    block.nominalSpeed = speedLimit;
+    return true;
+}
+
+float MotionQueue::junctionSpeed(const Block& previous, const Block& next) const
+{
+    const float limit = std::min(previous.nominalSpeed, next.nominalSpeed);
+
+    // junction deviation：以与两段相切、离拐点偏差为δ的圆弧近似拐角，
+    // 该圆弧上向心加速度不超过a：v² = a·δ·sin(θ/2) / (1 - sin(θ/2))
+    const float cosTheta = -previous.endTangent.dot(next.startTangent);
+    if (cosTheta < -0.999999f) {
+        return limit;  // 共线
+    }
+    if (cosTheta > 0.999999f) {
+        return 0.0f;   // 原路折返
+    }
+    const float sinHalf = std::sqrt(0.5f * (1.0f - cosTheta));
+    const float v2 = limits_.maxAcceleration * limits_.junctionDeviation * sinHalf / (1.0f - sinHalf);
+    return std::min(limit, std::sqrt(v2));
+}
+
+bool MotionQueue::rebase(const Vector3f& startPosition)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (progress_ > 0.0f || speed_ > 0.0f) {
+        return false;
+    }
+
+    std::deque<Block> rebuilt;
+    Vector3f start = startPosition;
+    for (const Block& queued : blocks_) {
+        Block block;
+        if (!buildBlock(queued.segment, start, block)) {
+            continue;
+        }
+        block.maxEntrySpeed = rebuilt.empty() ? 0.0f : junctionSpeed(rebuilt.back(), block);
+        start = block.end;
+        rebuilt.push_back(std::move(block));
+    }
+    blocks_.swap(rebuilt);
+    position_ = startPosition;
+    queueEnd_ = start;
+    replan();
+    return true;
+}
+
+bool MotionQueue::push(const MotionSegment& segment)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Block block;
+    if (!buildBlock(segment, queueEnd_, block)) {
+        return false;
+    }
+    block.maxEntrySpeed = blocks_.empty() ? 0.0f : junctionSpeed(blocks_.back(), block);
+    queueEnd_ = block.end;
+    blocks_.push_back(std::move(block));
+    replan();
+    return true;
+}
+
+void MotionQueue::replan()
+{
+    if (blocks_.empty()) {
+        return;
+    }
+    const float a2 = 2.0f * limits_.maxAcceleration;
+    const size_t window = std::min(blocks_.size(), static_cast<size_t>(std::max(limits_.lookAhead, 1)));
+
+    // 反向：窗口末端按停止处理，逐段求出能减速到下一段入口的最大入口速度
+    float exitSpeed = 0.0f;
+    for (size_t k = window; k-- > 1;) {
+        Block& b = blocks_[k];
+        b.exitSpeed = exitSpeed;
+        b.entrySpeed = std::min({b.maxEntrySpeed, b.nominalSpeed,
+                                 std::sqrt(exitSpeed * exitSpeed + a2 * b.length)});
+        exitSpeed = b.entrySpeed;
+    }
+    blocks_[0].entrySpeed = speed_;
+    blocks_[0].exitSpeed = exitSpeed;
+
+    // 正向：从当前速度出发，入口速度不超过前一段可加速到的速度
+    float reach = std::sqrt(speed_ * speed_ + a2 * std::max(blocks_[0].length - progress_, 0.0f));
+    for (size_t k = 0; k < window; ++k) {
+        Block& b = blocks_[k];
+        if (k > 0) {
+            reach = std::sqrt(b.entrySpeed * b.entrySpeed + a2 * b.length);
+        }
+        if (b.exitSpeed > reach) {
+            b.exitSpeed = reach;
+            if (k + 1 < window) {
+                blocks_[k + 1].entrySpeed = reach;
+            }
+        }
+    }
+}
+
+TrajectoryPoint MotionQueue::evaluate(const Block& block, float distance, float speed, float accel) const
+{
+    TrajectoryPoint point;
+    distance = std::clamp(distance, 0.0f, block.length);
+
+    switch (block.type) {
+    case MotionSegment::Type::Line:
+        point.position = block.start + block.direction * distance;
+        point.velocity = block.direction * speed;
+        point.acceleration = block.direction * accel;
+        break;
+    case MotionSegment::Type::Arc:
+    case MotionSegment::Type::Spiral: {
+        const float k = block.sweep / block.length;  // dφ/dd
+        const float phi = distance * k;
+        const Vector3f radial = std::cos(phi) * block.radialU + std::sin(phi) * block.radialV;
+        const Vector3f tangential = -std::sin(phi) * block.radialU + std::cos(phi) * block.radialV;
+        point.position = block.center + block.radius * radial + block.axis * (block.rise * distance / block.length);
+        const Vector3f unitTangent = block.radius * k * tangential + block.axis * (block.rise / block.length);
+        point.velocity = unitTangent * speed;
+        point.acceleration = unitTangent * accel - radial * (block.radius * k * k * speed * speed);
+        break;
+    }
+    case MotionSegment::Type::Spline: {
+        // 弧长 -> 样条时刻 O(1) 查表，切向/法向取样条解析导数
+        const TrajectoryPoint p = block.spline.evaluate(block.path.parameterAt(distance));
+
+        point.position = p.position;
+        const float ds = p.velocity.norm();
+        if (ds > 1e-6f) {
+            const Vector3f tangent = p.velocity / ds;
+            const Vector3f normalAccel = (p.acceleration - tangent * tangent.dot(p.acceleration)) / (ds * ds);
+            point.velocity = tangent * speed;
+            point.acceleration = tangent * accel + normalAccel * speed * speed;
+        }
+        break;
+    }
+    }
+    return point;
+}
+
+bool MotionQueue::step(float dt, TrajectoryPoint& point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const float accel = limits_.maxAcceleration;
+    float cycleAccel = 0.0f;
+
+    while (dt > 0.0f && !blocks_.empty()) {
+        Block& b = blocks_.front();
+        const float remaining = b.length - progress_;
+
+        // 梯形曲线：加速到段内上限，并保证能以a减速到出口速度
+        const float target = std::min(b.nominalSpeed, std::sqrt(b.exitSpeed * b.exitSpeed + 2.0f * accel * remaining));
+        const float next = speed_ < target ? std::min(target, speed_ + accel * dt)
+                                           : std::max(target, speed_ - accel * dt);
+        const float ds = 0.5f * (speed_ + next) * dt;
+
+        if (ds < remaining && remaining > kMinLength) {
+            cycleAccel = (next - speed_) / dt;
+            progress_ += ds;
+            speed_ = next;
+            point = evaluate(b, progress_, speed_, cycleAccel);
+            position_ = point.position;
+            return true;
+        }
+
+        // 本周期内走完当前段，剩余时间继续下一段
+        const float avg = 0.5f * (speed_ + next);
+        const float used = avg > 1e-9f ? std::min(remaining / avg, dt) : dt;
+        // 出口速度取走完本段时 (used时刻) 的速度，且不超过规划的衔接速度
+        const float endSpeed = std::min(speed_ + (next - speed_) * (used / dt), b.exitSpeed);
+        dt -= used;
+        speed_ = blocks_.size() > 1 ? endSpeed : 0.0f;
+        position_ = b.end;
+        progress_ = 0.0f;
+        blocks_.pop_front();
+        replan();  // 窗口后移，新段进入前瞻
+    }
+
+    if (blocks_.empty()) {
+        point = TrajectoryPoint();
+        point.position = position_;
+        speed_ = 0.0f;
+        return false;
+    }
+    point = evaluate(blocks_.front(), progress_, speed_, cycleAccel);
+    return true;
+}
+
+bool MotionQueue::busy() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !blocks_.empty();
+}
+
+size_t MotionQueue::pendingSegments() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.size();
+}
+
+float MotionQueue::currentSpeed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return speed_;
+}
+
+Vector3f MotionQueue::endPosition() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queueEnd_;
+}
+
+void MotionQueue::setLimits(const Limits& limits)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    limits_ = limits;
+    replan();
+}
+
+MotionQueue::Limits MotionQueue::limits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limits_;
+}
@@ -0,0 +1,148 @@
+#ifndef MOTION_QUEUE_H
+#define MOTION_QUEUE_H
+
+#include "arc_length_path.h"
+#include "robot_common.h"
+#include "spline_trajectory.h"
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 运动段描述 (笛卡尔空间，起点为上一段终点)
+ */
+struct MotionSegment
+{
+    enum class Type
+    {
+        Line,    // 直线到end
+        Arc,     // 绕center、以axis为法向逆时针转到end
+        Spiral,  // 绕过center的axis方向螺旋turns圈，每圈沿axis上升pitch
+        Spline   // 经过waypoints的样条
+    };
+
+    Type type = Type::Line;
+    Vector3f end = Vector3f::Zero();
+    Vector3f center = Vector3f::Zero();
+    Vector3f axis = Vector3f::UnitZ();
+    float turns = 1.0f;
+    float pitch = 0.0f;                // 螺旋每圈上升量 (m)
+    std::vector<Vector3f> waypoints;   // 样条路径点 (不含起点)
+    SplineKind splineKind = SplineKind::Cubic;
+    float feedrate = 0.05f;            // 期望速度 (m/s)
+
+    static MotionSegment line(const Vector3f& end, float feedrate);
+    static MotionSegment arc(const Vector3f& center, const Vector3f& end, const Vector3f& axis, float feedrate);
+    static MotionSegment spiral(const Vector3f& center, float turns, float pitch, float feedrate);
+    static MotionSegment spline(const std::vector<Vector3f>& waypoints, SplineKind kind, float feedrate);
+};
+
+/**
+ * @brief 带前瞻的运动队列 (类CNC规划器)
+ *
+ * 每段按起止切向计算拐角速度上限 (junction deviation)，在前瞻窗口内
+ * 反向/正向两遍求出各段衔接速度，段内按梯形速度曲线执行。
+ * 多段短运动连续衔接，只在拐角处按几何偏差限制减速，不再每段停到0。
+ * 入队与执行可在不同线程，内部加锁。
+ */
+class MotionQueue
+{
+public:
+    struct Limits
+    {
+        float maxAcceleration = 0.5f;       // 切向/向心加速度上限 (m/s²)
+        float maxFeedrate = 0.2f;           // 速度上限 (m/s)
+        float junctionDeviation = 0.0005f;  // 拐角允许偏离 (m)，越大拐角越快
+        int lookAhead = 16;                 // 前瞻段数
+    };
+
+    MotionQueue() : MotionQueue(Limits()) {}
+    explicit MotionQueue(const Limits& limits);
+
+    /**
+     * @brief 清空队列并设置下一段的起点 (机器人静止于此)
+     */
+    void reset(const Vector3f& startPosition);
+
+    /**
+     * @brief 把尚未开始执行的队列整体移到新起点：各段按原参数从新起点重新构建并重新规划
+     *
+     * 入队时的起点可能与开始执行时机器人实际所处位置不同 (例如期间执行过其他轨迹)，
+     * 开始执行前调用，第一段即从当前位置出发，不产生位置阶跃。新起点与段终点重合的段被跳过。
+     * @return false 如果队首段已开始执行 (此时不做修改)
+     */
+    bool rebase(const Vector3f& startPosition);
+
+    /**
+     * @brief 追加一段运动并重新规划前瞻窗口
+     * @return 段参数是否有效 (零长度、圆弧起止半径不一致等返回false)
+     */
+    bool push(const MotionSegment& segment);
+
+    /**
+     * @brief 推进dt秒并输出当前设定点
+     * @return 队列中是否仍有运动 (false时point为最后位置，速度为0)
+     */
+    bool step(float dt, TrajectoryPoint& point);
+
+    bool busy() const;
+    size_t pendingSegments() const;
+    float currentSpeed() const;
+    Vector3f endPosition() const;  // 已入队运动的终点
+
+    /**
+     * @brief 修改限幅并重新规划 (段内速度上限在入队时确定，只对之后入队的段生效)
+     */
+    void setLimits(const Limits& limits);
+    Limits limits() const;
+
+private:
+    // 规划用的段：几何按弧长参数化，另含速度规划结果
+    struct Block
+    {
+        MotionSegment segment;  // 原始段参数 (rebase时重新构建)
+        MotionSegment::Type type = MotionSegment::Type::Line;
+        Vector3f start = Vector3f::Zero();
+        Vector3f end = Vector3f::Zero();
+        float length = 0.0f;
+
+        // 直线
+        Vector3f direction = Vector3f::Zero();
+
+        // 圆弧/螺旋：center + r(cosφ·radialU + sinφ·radialV) + axis·rise·(d/length)
+        Vector3f center = Vector3f::Zero();
+        Vector3f axis = Vector3f::UnitZ();
+        Vector3f radialU = Vector3f::Zero();
+        Vector3f radialV = Vector3f::Zero();
+        float radius = 0.0f;
+        float sweep = 0.0f;
+        float rise = 0.0f;
+
+        // 样条：path为弧长 -> 样条时刻的均匀索引
+        SplineTrajectory spline;
+        ArcLengthPath path;
+
+        Vector3f startTangent = Vector3f::Zero();
+        Vector3f endTangent = Vector3f::Zero();
+
+        float nominalSpeed = 0.0f;   // 进给与向心加速度共同限制的段内速度上限
+        float maxEntrySpeed = 0.0f;  // 拐角速度上限
+        float entrySpeed = 0.0f;
+        float exitSpeed = 0.0f;
+    };
+
+    bool buildBlock(const MotionSegment& segment, const Vector3f& start, Block& block) const;
+    void replan();
+    float junctionSpeed(const Block& previous, const Block& next) const;
+    TrajectoryPoint evaluate(const Block& block, float distance, float speed, float accel) const;
+
+    mutable std::mutex mutex_;
+    Limits limits_;
+    std::deque<Block> blocks_;  // 队首为正在执行的段
+    Vector3f position_ = Vector3f::Zero();     // 当前设定点
+    Vector3f queueEnd_ = Vector3f::Zero();     // 最后一段终点
+    float progress_ = 0.0f;    // 队首段已走过的弧长
+    float speed_ = 0.0f;       // 当前速度
+};
+
+#endif // MOTION_QUEUE_H
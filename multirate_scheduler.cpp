@@ -0,0 +1,132 @@
+#include "multirate_scheduler.h"
+#include "monotonic_clock.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+void setError(std::string* error, const std::string& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+} // namespace
+
+MultiRateScheduler::MultiRateScheduler(int64_t basePeriodNs)
+    : basePeriodNs_(std::max<int64_t>(basePeriodNs, 1))
+{
+}
+
+bool MultiRateScheduler::addTask(const char* name, int64_t periodNs, int64_t budgetNs, Task task, int phase,
+                                 std::string* error)
+{
+    if (!task) {
+        setError(error, std::string("任务") + name + "为空");
+        return false;
+    }
+    if (periodNs < basePeriodNs_ || periodNs % basePeriodNs_ != 0) {
+        setError(error, std::string("任务") + name + "的周期" + std::to_string(periodNs / 1000) +
+                        "us不是基本节拍" + std::to_string(basePeriodNs_ / 1000) + "us的整数倍");
+        return false;
+    }
+    const uint64_t divider = static_cast<uint64_t>(periodNs / basePeriodNs_);
+    if (phase < 0 || static_cast<uint64_t>(phase) >= divider) {
+        setError(error, std::string("任务") + name + "的相位超出范围");
+        return false;
+    }
+
+    Entry entry;
+    entry.divider = divider;
+    entry.phase = static_cast<uint64_t>(phase);
+    entry.task = std::move(task);
+    entries_.push_back(std::move(entry));
+
+    RateStats stats;
+    stats.name = name;
+    stats.periodNs = periodNs;
+    stats.budgetNs = budgetNs;
+    stats_.push_back(stats);
+    return true;
+}
+
+void MultiRateScheduler::tick(int64_t nowNs)
+{
+    Clock& clock = Clock::instance();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        if (ticks_ % entry.divider != entry.phase) {
+            continue;
+        }
+        const int64_t begin = clock.nowNs();
+        entry.task(nowNs);
+        const int64_t elapsed = clock.nowNs() - begin;
+
+        RateStats& stats = stats_[i];
+        ++stats.runs;
+        stats.sumComputeNs += elapsed;
+        stats.maxComputeNs = std::max(stats.maxComputeNs, elapsed);
+        if (elapsed > stats.budgetNs) {
+            ++stats.overBudget;
+        }
+    }
+    ++ticks_;
+}
+
+void MultiRateScheduler::reset()
+{
+    ticks_ = 0;
+    for (RateStats& stats : stats_) {
+        stats.runs = 0;
+        stats.overBudget = 0;
+        stats.sumComputeNs = 0;
+        stats.maxComputeNs = 0;
+    }
+}
+
+double MultiRateScheduler::budgetUtilization() const
+{
+    double utilization = 0.0;
+    for (const RateStats& stats : stats_) {
+        utilization += static_cast<double>(stats.budgetNs) / static_cast<double>(stats.periodNs);
+    }
+    return utilization;
+}
+
+int64_t MultiRateScheduler::worstTickBudget() const
+{
+    // 节拍号对各任务的divider取模等于相位时该任务到期；逐个节拍枚举一个超周期
+    uint64_t hyper = 1;
+    for (const Entry& entry : entries_) {
+        uint64_t a = hyper;
+        uint64_t b = entry.divider;
+        while (b != 0) {
+            const uint64_t r = a % b;
+            a = b;
+            b = r;
+        }
+        hyper = hyper / a * entry.divider;
+        if (hyper > 100000) {
+            // 超周期过长时按全部同时到期估计
+            int64_t sum = 0;
+            for (const RateStats& stats : stats_) {
+                sum += stats.budgetNs;
+            }
+            return sum;
+        }
+    }
+
+    int64_t worst = 0;
+    for (uint64_t tick = 0; tick < hyper; ++tick) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (tick % entries_[i].divider == entries_[i].phase) {
+                sum += stats_[i].budgetNs;
+            }
+        }
+        worst = std::max(worst, sum);
+    }
+    return worst;
+}
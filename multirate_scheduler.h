@@ -0,0 +1,91 @@
+#ifndef MULTIRATE_SCHEDULER_H
+#define MULTIRATE_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 多速率任务调度 (单线程、确定性)
+ *
+ * 以最快任务的周期为基本节拍，每个任务的周期为节拍的整数倍，
+ * 由控制线程每个节拍调用一次tick()，到期的任务按注册顺序依次执行。
+ * 慢任务可指定相位，错开到不同节拍，避免与其他任务挤在同一节拍里。
+ * 每个任务的耗时单独统计，并与各自的预算比较。
+ */
+class MultiRateScheduler
+{
+public:
+    using Task = std::function<void(int64_t nowNs)>;
+
+    /**
+     * @brief 单个任务的耗时统计 (name指向注册时传入的字符串常量)
+     */
+    struct RateStats
+    {
+        const char* name = "";
+        int64_t periodNs = 0;
+        int64_t budgetNs = 0;
+        uint64_t runs = 0;
+        uint64_t overBudget = 0;     // 单次耗时超过预算的次数
+        int64_t sumComputeNs = 0;
+        int64_t maxComputeNs = 0;
+
+        double meanComputeUs() const { return runs > 0 ? sumComputeNs * 1e-3 / runs : 0.0; }
+    };
+
+    explicit MultiRateScheduler(int64_t basePeriodNs);
+
+    /**
+     * @brief 注册任务 (仅在开始tick之前调用)
+     * @param name 任务名 (字符串常量)
+     * @param periodNs 任务周期，须为基本节拍的整数倍
+     * @param budgetNs 单次执行的耗时预算
+     * @param phase 在第几个节拍执行 (0 到 周期/节拍-1)
+     * @return 参数是否有效
+     */
+    bool addTask(const char* name, int64_t periodNs, int64_t budgetNs, Task task, int phase = 0,
+                 std::string* error = nullptr);
+
+    /**
+     * @brief 执行一个节拍内到期的任务
+     * @param nowNs 节拍开始时刻，传给各任务
+     */
+    void tick(int64_t nowNs);
+
+    /**
+     * @brief 节拍计数和统计清零 (任务保留)
+     */
+    void reset();
+
+    int64_t basePeriod() const { return basePeriodNs_; }
+    uint64_t ticks() const { return ticks_; }
+
+    /**
+     * @brief 各任务预算之和占所属周期的比例之和 (大于1说明平均意义上就排不下)
+     */
+    double budgetUtilization() const;
+
+    /**
+     * @brief 最坏节拍的预算总和 (所有任务同时到期时)，应小于基本节拍
+     */
+    int64_t worstTickBudget() const;
+
+    const std::vector<RateStats>& stats() const { return stats_; }
+
+private:
+    struct Entry
+    {
+        uint64_t divider = 1;   // 每多少个节拍执行一次
+        uint64_t phase = 0;
+        Task task;
+    };
+
+    int64_t basePeriodNs_;
+    uint64_t ticks_ = 0;
+    std::vector<Entry> entries_;
+    std::vector<RateStats> stats_;   // 与entries_一一对应
+};
+
+#endif // MULTIRATE_SCHEDULER_H
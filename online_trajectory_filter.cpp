@@ -0,0 +1,97 @@
+#include "online_trajectory_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+inline float signOf(float x)
+{
+    return x > 0.0f ? 1.0f : (x < 0.0f ? -1.0f : 0.0f);
+}
+
+} // namespace
+
+OnlineTrajectoryFilter::OnlineTrajectoryFilter(const Limits& limits)
+    : limits_(limits)
+{
+}
+
+void OnlineTrajectoryFilter::reset(int axis, float position, float velocity)
+{
+    state_[axis].position = position;
+    state_[axis].velocity = std::clamp(velocity, -limits_.maxVelocity[axis], limits_.maxVelocity[axis]);
+    state_[axis].acceleration = 0.0f;
+    initialized_[axis] = true;
+}
+
+void OnlineTrajectoryFilter::invalidate()
+{
+    initialized_.fill(false);
+}
+
+const OnlineTrajectoryFilter::AxisState& OnlineTrajectoryFilter::update(int axis, float targetPosition,
+                                                                        float targetVelocity, float dt)
+{
+    AxisState& s = state_[axis];
+    if (!initialized_[axis]) {
+        reset(axis, targetPosition, targetVelocity);
+        return s;
+    }
+    if (!(dt > 0.0f)) {
+        return s;
+    }
+
+    const float V = limits_.maxVelocity[axis];
+    const float A = limits_.maxAcceleration[axis];
+    const float J = limits_.maxJerk[axis];
+
+    // 1. 参考速度：剩余距离e内能减到目标速度的最大速度差w
+    //    减速距离 = w²/(2A) + w·A/(2J) (含加速度建立时间)，反解w；离散时一个周期不越过目标
+    const float e = targetPosition - s.position;
+    const float absE = std::abs(e);
+    const float ramp = A / (2.0f * J);
+    const float root = std::sqrt(ramp * ramp + 2.0f * absE / A);
+    float w = A * (root - ramp);
+    float slope = 1.0f / root;  // dw/d|e|
+    if (w > absE / dt) {
+        w = absE / dt;
+        slope = 0.0f;
+    }
+    float vRef = targetVelocity + signOf(e) * w;
+    if (std::abs(vRef) > V) {
+        vRef = std::clamp(vRef, -V, V);
+        slope = 0.0f;
+    }
+
+    // 沿刹车曲线运动时参考速度本身的变化率，作为加速度前馈
+    const float aFeedForward = std::clamp(slope * (targetVelocity - s.velocity), -A, A);
+
+    // 2. 参考加速度：预测加速度以J回到前馈值后的速度，时间最优地消除速度误差
+    const float aOffset = s.acceleration - aFeedForward;
+    const float vPredicted = s.velocity + aOffset * std::abs(aOffset) / (2.0f * J);
+    const float dv = vRef - vPredicted;
+    const float absDv = std::abs(dv);
+    const float aRef = std::clamp(aFeedForward + signOf(dv) * std::min(std::sqrt(2.0f * J * absDv), absDv / dt), -A, A);
+
+    // 3. 加加速度限幅后积分一个周期
+    const float jerk = std::clamp((aRef - s.acceleration) / dt, -J, J);
+    s.position += dt * (s.velocity + dt * (0.5f * s.acceleration + dt * jerk / 6.0f));
+    s.velocity += dt * (s.acceleration + 0.5f * dt * jerk);
+    s.acceleration += dt * jerk;
+    s.velocity = std::clamp(s.velocity, -V, V);
+
+    return s;
+}
+
+TrajectoryPoint OnlineTrajectoryFilter::update(const Vector3f& targetPosition, const Vector3f& targetVelocity, float dt)
+{
+    TrajectoryPoint point;
+    for (int axis = 0; axis < 3; ++axis) {
+        const AxisState& s = update(axis, targetPosition[axis], targetVelocity[axis], dt);
+        point.position[axis] = s.position;
+        point.velocity[axis] = s.velocity;
+        point.acceleration[axis] = s.acceleration;
+    }
+    return point;
+}
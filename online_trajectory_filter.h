@@ -0,0 +1,73 @@
+#ifndef ONLINE_TRAJECTORY_FILTER_H
+#define ONLINE_TRAJECTORY_FILTER_H
+
+#include "robot_common.h"
+#include <array>
+
+/**
+ * @brief 控制周期内运行的加加速度受限设定点滤波器 (每关节独立)
+ *
+ * 输入任意目标位置/速度 (可跳变)，输出满足速度、加速度、加加速度限制的
+ * 连续指令。每轴采用级联的时间最优切换律：
+ *     位置误差 -> 可刹停的参考速度 -> 可平滑到达的参考加速度 -> 加加速度
+ * 每周期只有固定次数的乘加和两次开方，无迭代，最坏耗时与平均耗时相同。
+ */
+class OnlineTrajectoryFilter
+{
+public:
+    struct Limits
+    {
+        Vector3f maxVelocity = Vector3f::Constant(30.0f);        // rad/s
+        Vector3f maxAcceleration = Vector3f::Constant(200.0f);   // rad/s²
+        Vector3f maxJerk = Vector3f::Constant(10000.0f);         // rad/s³
+    };
+
+    struct AxisState
+    {
+        float position = 0.0f;
+        float velocity = 0.0f;
+        float acceleration = 0.0f;
+    };
+
+    OnlineTrajectoryFilter() : OnlineTrajectoryFilter(Limits()) {}
+    explicit OnlineTrajectoryFilter(const Limits& limits);
+
+    void setLimits(const Limits& limits) { limits_ = limits; }
+    const Limits& limits() const { return limits_; }
+
+    /**
+     * @brief 将某轴状态设为给定值 (启动时对齐到实测位置)
+     */
+    void reset(int axis, float position, float velocity = 0.0f);
+
+    /**
+     * @brief 所有轴标记为未初始化，下次update时以目标值对齐
+     */
+    void invalidate();
+
+    bool initialized(int axis) const { return initialized_[axis]; }
+
+    /**
+     * @brief 推进一个周期
+     * @param axis 轴号 0-2
+     * @param targetPosition 目标位置
+     * @param targetVelocity 到达目标时的速度 (跟踪运动中的目标)
+     * @param dt 周期 (秒)
+     * @return 本周期输出状态
+     */
+    const AxisState& update(int axis, float targetPosition, float targetVelocity, float dt);
+
+    /**
+     * @brief 三轴同时推进
+     */
+    TrajectoryPoint update(const Vector3f& targetPosition, const Vector3f& targetVelocity, float dt);
+
+    const AxisState& state(int axis) const { return state_[axis]; }
+
+private:
+    Limits limits_;
+    std::array<AxisState, 3> state_{};
+    std::array<bool, 3> initialized_{};
+};
+
+#endif // ONLINE_TRAJECTORY_FILTER_H
@@ -0,0 +1,172 @@
+#include "realtime_runtime.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+// 逐页写栈，使其在mlockall后全部驻留；noinline避免被优化进调用者的栈帧
+__attribute__((noinline)) void prefaultStack(size_t bytes)
+{
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        stack[offset] = 0;
+    }
+}
+
+// 分配并触碰一块堆后释放；配合 M_TRIM_THRESHOLD/M_MMAP_MAX 让这些页留在malloc内部供后续复用。
+// 这两项是进程级设置，leave()不恢复 (glibc无法读回原值)：此后整个进程不再把空闲堆还给系统，
+// 大块分配也不再走mmap
+void prefaultHeap(size_t bytes)
+{
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    unsigned char* heap = static_cast<unsigned char*>(std::malloc(bytes));
+    if (!heap) {
+        return;
+    }
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        heap[offset] = 0;
+    }
+    std::free(heap);
+}
+
+void append(std::string& message, const char* step, int error)
+{
+    if (!message.empty()) {
+        message += "; ";
+    }
+    message += step;
+    if (error != 0) {
+        message += "失败 (";
+        message += std::strerror(error);
+        message += ")";
+    }
+}
+
+} // namespace
+
+RealtimeRuntime::RealtimeRuntime(const RealtimeParams& params)
+    : params_(params)
+{
+}
+
+RealtimeRuntime::~RealtimeRuntime()
+{
+    leave();
+}
+
+bool RealtimeRuntime::enter()
+{
+    status_ = Status();
+    if (!params_.enabled) {
+        status_.message = "实时模式未启用";
+        return false;
+    }
+
+    // 1. CPU绑定 (记下原亲和性以便恢复)
+    if (params_.cpuMask != 0) {
+        CPU_ZERO(&previousAffinity_);
+        pthread_getaffinity_np(pthread_self(), sizeof(previousAffinity_), &previousAffinity_);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+            if (params_.cpuMask & (uint64_t(1) << cpu)) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        status_.affinity = error == 0;
+        append(status_.message, "CPU绑定", error);
+    }
+
+    // 2. 调度策略 (记下原策略以便恢复)
+    sched_param previous{};
+    pthread_getschedparam(pthread_self(), &previousPolicy_, &previous);
+    previousPriority_ = previous.sched_priority;
+    sched_param fifo{};
+    fifo.sched_priority = std::clamp(params_.priority, sched_get_priority_min(SCHED_FIFO),
+                                     sched_get_priority_max(SCHED_FIFO));
+    const int schedError = pthread_setschedparam(pthread_self(), SCHED_FIFO, &fifo);
+    status_.fifo = schedError == 0;
+    append(status_.message, "SCHED_FIFO", schedError);
+
+    // 3. 锁定内存，之后再预触碰，使这些页在锁定状态下驻留
+    if (params_.lockMemory) {
+        const int lockError = mlockall(MCL_CURRENT | MCL_FUTURE) == 0 ? 0 : errno;
+        status_.memoryLocked = lockError == 0;
+        append(status_.message, "mlockall", lockError);
+    }
+    prefaultStack(params_.stackPrefaultBytes);
+    prefaultHeap(params_.heapPrefaultBytes);
+    status_.prefaulted = true;
+
+    entered_ = true;
+    return status_.realtime() && (params_.cpuMask == 0 || status_.affinity);
+}
+
+void RealtimeRuntime::leave()
+{
+    if (!entered_) {
+        return;
+    }
+    if (status_.fifo) {
+        sched_param previous{};
+        previous.sched_priority = previousPriority_;
+        pthread_setschedparam(pthread_self(), previousPolicy_, &previous);
+    }
+    if (status_.affinity) {
+        pthread_setaffinity_np(pthread_self(), sizeof(previousAffinity_), &previousAffinity_);
+    }
+    if (status_.memoryLocked) {
+        munlockall();
+    }
+    entered_ = false;
+}
+
+PeriodicTimer::PeriodicTimer(int64_t periodNs)
+    : periodNs_(periodNs)
+{
+}
+
+void PeriodicTimer::start()
+{
+    lastWakeNs_ = Clock::now();
+    nextWakeNs_ = lastWakeNs_ + periodNs_;
+}
+
+bool PeriodicTimer::wait()
+{
+    Clock& clock = Clock::instance();
+    const int64_t now = clock.nowNs();
+    stats_.maxComputeNs = std::max(stats_.maxComputeNs, now - lastWakeNs_);
+    ++stats_.cycles;
+
+    bool overrun = false;
+    if (now >= nextWakeNs_) {
+        // 已错过唤醒时刻：不休眠，并跳过整周期错过的唤醒
+        overrun = true;
+        ++stats_.overruns;
+        const int64_t missed = (now - nextWakeNs_) / periodNs_;
+        stats_.missedCycles += static_cast<uint64_t>(missed);
+        nextWakeNs_ += missed * periodNs_;
+    } else {
+        clock.sleepUntil(nextWakeNs_);
+    }
+
+    lastWakeNs_ = clock.nowNs();
+    const int64_t latency = std::max<int64_t>(0, lastWakeNs_ - nextWakeNs_);
+    stats_.maxWakeLatencyNs = std::max(stats_.maxWakeLatencyNs, overrun ? 0 : latency);
+    stats_.sumWakeLatencyNs += overrun ? 0 : latency;
+    nextWakeNs_ += periodNs_;
+    return overrun;
+}
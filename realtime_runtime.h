@@ -0,0 +1,122 @@
+#ifndef REALTIME_RUNTIME_H
+#define REALTIME_RUNTIME_H
+
+#include "monotonic_clock.h"
+#include "robot_common.h"
+#include <cstdint>
+#include <sched.h>
+#include <string>
+
+/**
+ * @brief 控制线程的实时运行环境
+ *
+ * enter() 在调用线程上依次尝试：CPU绑定、SCHED_FIFO、mlockall、预触碰栈和堆。
+ * 任一步骤因权限不足失败时只记录原因并继续，线程仍按普通调度运行；
+ * leave() 恢复CPU亲和性和调度策略并解除内存锁定；预触碰堆时修改的malloc参数是进程级的，不恢复。
+ */
+class RealtimeRuntime
+{
+public:
+    struct Status
+    {
+        bool affinity = false;       // CPU绑定成功
+        bool fifo = false;           // SCHED_FIFO生效
+        bool memoryLocked = false;   // mlockall成功
+        bool prefaulted = false;     // 栈和堆已预触碰
+        std::string message;         // 各步骤结果，用于日志
+
+        bool realtime() const { return fifo && memoryLocked; }
+    };
+
+    explicit RealtimeRuntime(const RealtimeParams& params);
+    ~RealtimeRuntime();
+
+    RealtimeRuntime(const RealtimeRuntime&) = delete;
+    RealtimeRuntime& operator=(const RealtimeRuntime&) = delete;
+
+    /**
+     * @brief 对调用线程应用实时设置 (params.enabled为false时什么也不做)
+     * @return 是否全部生效
+     */
+    bool enter();
+
+    /**
+     * @brief 恢复调用线程的CPU亲和性和调度策略，解除内存锁定
+     */
+    void leave();
+
+    const Status& status() const { return status_; }
+
+private:
+    RealtimeParams params_;
+    Status status_;
+    bool entered_ = false;
+    int previousPolicy_ = 0;
+    int previousPriority_ = 0;
+    cpu_set_t previousAffinity_{};
+};
+
+/**
+ * @brief 控制周期统计
+ */
+struct CycleStats
+{
+    uint64_t cycles = 0;
+    uint64_t overruns = 0;          // 本周期计算结束时已过下一唤醒时刻的次数
+    uint64_t missedCycles = 0;      // 因超时整周期跳过的唤醒次数
+    int64_t maxWakeLatencyNs = 0;   // 实际唤醒时刻晚于预定时刻的最大值
+    int64_t sumWakeLatencyNs = 0;
+    int64_t maxComputeNs = 0;       // 唤醒到下次休眠之间的最长耗时
+    uint64_t feedbackCycles = 0;    // 反馈触发模式：由新反馈触发的周期数
+    uint64_t feedbackTimeouts = 0;  // 反馈触发模式：等待超时、按定时兜底的周期数
+
+    double meanWakeLatencyUs() const { return cycles > 0 ? sumWakeLatencyNs * 1e-3 / cycles : 0.0; }
+};
+
+/**
+ * @brief 按绝对时刻唤醒的周期定时器
+ *
+ * 唤醒时刻按周期累加，不会因每周期的计算耗时而漂移；
+ * 计算超过一个周期时跳过已错过的唤醒，避免随后连续补跑。
+ * 时间取自 Clock::instance()，默认即CLOCK_MONOTONIC + clock_nanosleep(TIMER_ABSTIME)。
+ */
+class PeriodicTimer
+{
+public:
+    explicit PeriodicTimer(int64_t periodNs);
+
+    void setPeriod(int64_t periodNs) { periodNs_ = periodNs; }
+    int64_t period() const { return periodNs_; }
+
+    /**
+     * @brief 以当前时刻为起点，下次唤醒在一个周期之后
+     */
+    void start();
+
+    /**
+     * @brief 休眠到下一个唤醒时刻并更新统计
+     * @return 本周期是否超时 (无需休眠)
+     */
+    bool wait();
+
+    const CycleStats& stats() const { return stats_; }
+    void resetStats() { stats_ = CycleStats(); }
+
+    /**
+     * @brief 本周期实际唤醒时刻 (纳秒)
+     */
+    int64_t lastWakeNs() const { return lastWakeNs_; }
+
+    /**
+     * @brief 下一个预定唤醒时刻 (纳秒)
+     */
+    int64_t nextWakeNs() const { return nextWakeNs_; }
+
+private:
+    int64_t periodNs_;
+    int64_t nextWakeNs_ = 0;
+    int64_t lastWakeNs_ = 0;
+    CycleStats stats_;
+};
+
+#endif // REALTIME_RUNTIME_H
@@ -2,6 +2,8 @@
 #define ROBOT_COMMON_H
 
 #include <eigen3/Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 /**
@@ -25,11 +27,11 @@ struct JointState
     int jointIndex;
     float position;      // 关节位置 (rad)
     float velocity;      // 关节速度 (rad/s)
-    float timestamp;     // 时间戳 (s)
+    int64_t timestampNs; // 串口接收时刻 (Clock::now()，纳秒)
 
-    JointState() : jointIndex(0), position(0), velocity(0), timestamp(0) {}
-    JointState(int idx, float pos, float vel, float t = 0)
-        : jointIndex(idx), position(pos), velocity(vel), timestamp(t) {}
+    JointState() : jointIndex(0), position(0), velocity(0), timestampNs(0) {}
+    JointState(int idx, float pos, float vel, int64_t tNs = 0)
+        : jointIndex(idx), position(pos), velocity(vel), timestampNs(tNs) {}
 };
 
 /**
@@ -110,8 +112,49 @@ struct RobotParams
  */
 enum class TrajectoryType
 {
-    Sine,   // 正弦轨迹
-    Spiral  // 螺旋线轨迹
+    Sine,     // 正弦轨迹
+    Spiral,   // 螺旋线轨迹
+    Waypoint, // 路径点样条轨迹
+    Path      // 恒定末端速度的几何路径 (按弧长参数化)
+};
+
+/**
+ * @brief 恒速路径形状 (TrajectoryType::Path)
+ */
+enum class PathShape
+{
+    Circle,   // 圆，圆心 (spiralX0, spiralY0, spiralZ0)，半径spiralAmplitude，pathTurns圈
+    Line,     // 直线，从中心到pathEnd
+    Figure8,  // 8字形，宽度2·spiralAmplitude，pathTurns遍
+    Spiral    // 平面阿基米德螺线，半径由0增大到spiralAmplitude，pathTurns圈
+};
+
+/**
+ * @brief 轨迹所在空间 (预计算表的通道含义)
+ */
+enum class TrajectorySpace
+{
+    Cartesian,  // 末端位置/速度/加速度 (m, m/s, m/s²)
+    Joint       // 关节角度/角速度/角加速度 (rad, rad/s, rad/s²)
+};
+
+/**
+ * @brief 路径点样条类型
+ */
+enum class SplineKind
+{
+    Cubic,   // 三次样条，C2连续，端点速度为0
+    Quintic  // 五次样条，端点速度和加速度均为0
+};
+
+/**
+ * @brief 预计算轨迹表的存储编码
+ */
+enum class TrajectoryEncoding
+{
+    Float32,  // 原始float，无损
+    Int16,    // int16定点，每通道独立scale/offset
+    Float16   // 半精度浮点，每通道归一化到[-1, 1]后存储
 };
 
 /**
@@ -123,6 +166,7 @@ struct TrajectoryParams
 
     // 通用参数
     float duration = 6.0f;          // 轨迹总时长 (秒)
+    TrajectoryEncoding storageEncoding = TrajectoryEncoding::Float32;  // 预计算表编码
 
     // 螺旋线轨迹参数
     float spiralAmplitude = 0.025f;    // 螺旋线幅度 (m)
@@ -137,6 +181,20 @@ struct TrajectoryParams
     float sineAmplitude2 = 1.0f;   // 关节2幅度 (rad)
     float sineAmplitude3 = 1.0f;   // 关节3幅度 (rad)
     float sineFrequency = 1.0f;    // 正弦频率 (Hz)
+
+    // 路径点样条轨迹参数
+    std::vector<Vector3f> waypoints;           // 路径点 (笛卡尔m 或 关节rad)
+    std::vector<float> waypointTimes;          // 到达各路径点的时刻 (秒)，为空时在duration内均匀分布
+    TrajectorySpace waypointSpace = TrajectorySpace::Cartesian;
+    SplineKind splineKind = SplineKind::Cubic;
+
+    // 恒速路径参数 (中心与尺寸沿用螺旋线的spiralX0/Y0/Z0和spiralAmplitude)
+    // 速度曲线为梯形：起点静止，以pathAcceleration加速到pathSpeed匀速，再对称减速停在终点
+    PathShape pathShape = PathShape::Circle;
+    float pathSpeed = 0.02f;                   // 匀速段末端速度 (m/s)
+    float pathAcceleration = 0.1f;             // 起停段切向加速度 (m/s²)，<=0时不设加减速段 (起止处速度阶跃)
+    float pathTurns = 1.0f;                    // 圈数/遍数
+    Vector3f pathEnd = Vector3f(0.19f, 0.05f, 0.0f);  // 直线终点 (m)
 };
 
 /**
@@ -153,6 +211,28 @@ struct TrajectoryPoint
         : position(pos), velocity(vel), acceleration(acc) {}
 };
 
+/**
+ * @brief 控制周期的触发方式
+ */
+enum class CycleTrigger
+{
+    Timer,      // 固定周期定时唤醒
+    Feedback    // 所有关节都收到新反馈即开始计算，超时则按定时兜底
+};
+
+/**
+ * @brief 实时运行参数 (控制线程调度)
+ */
+struct RealtimeParams
+{
+    bool enabled = false;             // 关闭时按普通线程运行
+    int priority = 80;                // SCHED_FIFO优先级 (1-99)
+    uint64_t cpuMask = 0;             // 绑定的CPU位掩码，0为不绑定
+    bool lockMemory = true;           // mlockall锁定当前及以后的内存页
+    size_t stackPrefaultBytes = 512 * 1024;       // 预先触碰的栈大小
+    size_t heapPrefaultBytes = 8 * 1024 * 1024;   // 预先触碰并保留给malloc的堆大小
+};
+
 /**
  * @brief 控制参数结构体
  */
@@ -163,8 +243,32 @@ struct ControlParams
     float k2 = 0.1f;  // 速度增益
     float k3 = 1.0f;  // 前馈增益
 
-    // 控制周期（毫秒）
-    int controlPeriod = 1;  // 默认1ms = 1000Hz
+    // 控制周期 (微秒)：内环关节控制的周期，也是多速率调度的基本节拍；默认1000us = 1kHz，可设为250us (4kHz)
+    int controlPeriodUs = 1000;
+
+    // 轨迹/前馈更新周期与监控任务周期 (微秒)，须为controlPeriodUs的整数倍
+    int trajectoryPeriodUs = 1000;
+    int supervisoryPeriodUs = 10000;
+
+    // 周期触发方式；Feedback模式下等待反馈的最长时间 (微秒)，超时即以现有状态计算
+    CycleTrigger cycleTrigger = CycleTrigger::Timer;
+    int feedbackTimeoutUs = 1500;
+
+    // 按指令轮次同步反馈：周期开始时等待上一轮指令的各关节回报到齐 (最多syncTimeoutUs微秒)，
+    // 只用同一轮的状态计算；feedbackJointMask为应回报的关节 (bit0对应关节1)
+    bool syncFeedback = false;
+    int syncTimeoutUs = 300;
+    uint32_t feedbackJointMask = 0x7;
+
+    // 融合流水线：控制线程直接完成 读串口 → 提取帧 → 解码 → 控制 → 编码 → 写串口，
+    // 运行期间串口接收线程和CAN解析线程停止；由连接面板的"控制流水线"选择
+    bool fusedPipeline = false;
+
+    // 轨迹时间缩放 (速度倍率)，1.0为原速
+    float timeScale = 1.0f;
+
+    // 实时调度
+    RealtimeParams realtime;
 
     // 轨迹参数
     TrajectoryParams trajectory;
@@ -4,11 +4,16 @@
 RobotModel::RobotModel(const RobotParams& params)
     : params_(params)
 {
+    // 旋量轴与零位位姿依赖DH参数，必须在任何运动学计算前求出
+    CalculateSList();
+    calculateZeroConfigPoseM();
 }
 
 void RobotModel::setParameters(const RobotParams& params)
 {
     params_ = params;
+    CalculateSList();
+    calculateZeroConfigPoseM();
 }
 
 void RobotModel::CalculateSList()
@@ -1,19 +1,26 @@
 #include "robotcontroller.h"
 #include "SerialPort.h"
+#include "trajectory_cache.h"
+#include "can_frame_codec.h"
+#include "fused_serial_io.h"
 
 #include <cmath>
-#include <QDateTime>
-#include <chrono>
-#include <thread>
 
 ///////////////////////////// ControlWorker 实现 /////////////////////////////
 
 ControlWorker::ControlWorker(QObject *parent)
     : QObject(parent)
 {
+    // 轨迹表缓存：内存LRU + 磁盘，切换回用过的配置或重启时免重算
+    auto cache = std::make_shared<TrajectoryCache>(64u << 20, TrajectoryCache::defaultDirectory());
+
     // 创建默认的机器人模型和轨迹生成器
     robotModel_ = std::make_unique<RobotModel>(params_.robotParams);
-    trajectoryGenerator_ = std::make_unique<TrajectoryGenerator>(params_.trajectory);
+    trajectoryGenerator_ = std::make_unique<TrajectoryGenerator>(params_.trajectory, cache);
+
+    // 运动队列默认从螺旋线起点出发，开始执行时再移到当时的设定/实测位置
+    motionQueue_ = std::make_unique<MotionQueue>();
+    motionQueue_->reset(trajectoryGenerator_->generateSpiralPoint(0.0f).position);
 }
 
 void ControlWorker::start()
@@ -23,13 +30,82 @@ void ControlWorker::start()
         return;
     }
 
+    if (!preflightCheck()) {
+        emit logMessage(QStringLiteral("轨迹预检未通过，拒绝启动"));
+        // RobotController已标记为运行中，融合模式下界面也已暂停接收线程，需通知其恢复
+        emit controlStatusChanged(false);
+        return;
+    }
+
     running_.store(true);
-    startTime_ = getCurrentTime();
+    startTimeNs_ = Clock::now();
+    trajectoryTimeNs_ = 0;
+    commandValid_ = false;
+    commandFilter_.invalidate();  // 首个周期对齐到实测状态
+
+    int controlPeriodUs = 0;
+    {
+        QMutexLocker locker(&paramsMutex_);
+        controlPeriodUs = params_.controlPeriodUs;
+    }
+    emit logMessage(QStringLiteral("控制线程已启动，周期: %1us").arg(controlPeriodUs));
 
-    emit logMessage(QStringLiteral("控制线程已启动，周期: %1ms").arg(controlPeriodMs_));
+    // 实时调度：权限不足时各步骤单独降级，控制循环照常运行
+    RealtimeParams realtime;
+    {
+        QMutexLocker locker(&paramsMutex_);
+        realtime = params_.realtime;
+    }
+    RealtimeRuntime runtime(realtime);
+    if (realtime.enabled) {
+        const bool full = runtime.enter();
+        emit logMessage(QStringLiteral("实时模式%1: %2")
+                        .arg(full ? QStringLiteral("已启用") : QStringLiteral("部分降级"))
+                        .arg(QString::fromStdString(runtime.status().message)));
+    }
 
     // 执行控制循环
     controlLoop();
+    runtime.leave();
+
+    const CycleStats stats = cycleStats();
+    emit logMessage(QStringLiteral("控制周期统计: %1周期，超时%2次 (跳过%3周期)，唤醒延迟均值%4us/最大%5us，最长计算%6us")
+                    .arg(stats.cycles)
+                    .arg(stats.overruns)
+                    .arg(stats.missedCycles)
+                    .arg(stats.meanWakeLatencyUs(), 0, 'f', 1)
+                    .arg(stats.maxWakeLatencyNs / 1000)
+                    .arg(stats.maxComputeNs / 1000));
+    for (const MultiRateScheduler::RateStats &rate : rateStats()) {
+        emit logMessage(QStringLiteral("任务%1 (周期%2us): %3次，耗时均值%4us/最大%5us，超预算(%6us)%7次")
+                        .arg(QString::fromUtf8(rate.name))
+                        .arg(rate.periodNs / 1000)
+                        .arg(rate.runs)
+                        .arg(rate.meanComputeUs(), 0, 'f', 1)
+                        .arg(rate.maxComputeNs / 1000)
+                        .arg(rate.budgetNs / 1000)
+                        .arg(rate.overBudget));
+    }
+    if (stats.feedbackCycles + stats.feedbackTimeouts > 0) {
+        emit logMessage(QStringLiteral("反馈触发: %1周期，超时兜底%2次")
+                        .arg(stats.feedbackCycles)
+                        .arg(stats.feedbackTimeouts));
+    }
+    emit logMessage(QStringLiteral("实测状态年龄: 均值%1us，最大%2us，缺失%3次")
+                    .arg(stateAge_.meanAgeUs(), 0, 'f', 1)
+                    .arg(stateAge_.maxAgeNs / 1000)
+                    .arg(stateAge_.missing));
+    const FeedbackSyncStats sync = feedbackAssembler_.stats();
+    if (sync.rounds > 0) {
+        emit logMessage(QStringLiteral("反馈同步: %1轮，凑齐%2轮，缺失 J1:%3 J2:%4 J3:%5，迟到帧%6，轮内最大时差%7us")
+                        .arg(sync.rounds)
+                        .arg(sync.completeRounds)
+                        .arg(sync.missing[0])
+                        .arg(sync.missing[1])
+                        .arg(sync.missing[2])
+                        .arg(sync.lateFrames)
+                        .arg(sync.maxSkewNs / 1000));
+    }
 
     emit logMessage(QStringLiteral("控制线程已停止"));
 }
@@ -39,32 +115,31 @@ void ControlWorker::stop()
     running_.store(false);
 }
 
-void ControlWorker::updateJointState(const JointState &state)
-{
-    QMutexLocker locker(&stateMutex_);
-    if (state.jointIndex >= 1 && state.jointIndex <= 3) {
-        jointStates_[state.jointIndex] = state;
-    }
-}
-
 void ControlWorker::setControlParams(const ControlParams &params)
 {
-    QMutexLocker locker(&paramsMutex_);
-    params_ = params;
-    controlPeriodMs_ = params.controlPeriod;
-
-    // 更新模型和生成器
-    updateModelFromParams();
+    bool externalCleared = false;
+    {
+        QMutexLocker locker(&paramsMutex_);
+        params_ = params;
+        timeScale_.store(params.timeScale);
+
+        // 更新模型和生成器
+        externalCleared = updateModelFromParams();
+    }
+    if (externalCleared) {
+        emit logMessage(QStringLiteral("轨迹参数已修改，放弃外部轨迹源 (文件/时间最优/重规划)，按新参数生成"));
+    }
 }
 
 void ControlWorker::initTrajectory()
 {
     trajectoryInitialized_.store(true);
-    startTime_ = getCurrentTime();
+    startTimeNs_ = Clock::now();
+    trajectoryTimeNs_ = 0;
     emit logMessage(QStringLiteral("轨迹跟踪已初始化"));
 }
 
-void ControlWorker::updateModelFromParams()
+bool ControlWorker::updateModelFromParams()
 {
     QMutexLocker locker(&modelMutex_);
 
@@ -72,120 +147,555 @@ void ControlWorker::updateModelFromParams()
         robotModel_->setParameters(params_.robotParams);
     }
 
-    if (trajectoryGenerator_) {
-        trajectoryGenerator_->setParameters(params_.trajectory);
+    if (!trajectoryGenerator_) {
+        return false;
     }
+    trajectoryGenerator_->setRobotParams(params_.robotParams);
+    const bool trajectoryChanged =
+        TrajectoryGenerator::parameterDependencies(trajectoryGenerator_->getParameters(), params_.trajectory) !=
+        TrajectoryGenerator::DependsNone;
+    trajectoryGenerator_->setParameters(params_.trajectory);
+
+    // 外部轨迹源不随参数更新：轨迹参数被修改时改回按参数生成，否则修改会被静默忽略
+    if (trajectoryChanged && trajectoryGenerator_->hasExternalTrajectory()) {
+        trajectoryGenerator_->clearExternalTrajectory();
+        return true;
+    }
+    return false;
 }
 //控制循环函数，持续计算控制命令并发送
 void ControlWorker::controlLoop()
 {
-    auto nextWakeTime = std::chrono::steady_clock::now();
+    CycleTrigger trigger = CycleTrigger::Timer;
+    int64_t feedbackTimeoutNs = 0;
+    bool syncFeedback = false;
+    int64_t syncTimeoutNs = 0;
+    int64_t periodNs = Clock::kNsPerMs;
+    int64_t trajectoryPeriodNs = Clock::kNsPerMs;
+    int64_t supervisoryPeriodNs = 10 * Clock::kNsPerMs;
+    bool fused = false;
+    {
+        QMutexLocker locker(&paramsMutex_);
+        trigger = params_.cycleTrigger;
+        feedbackTimeoutNs = static_cast<int64_t>(params_.feedbackTimeoutUs) * 1000;
+        syncFeedback = params_.syncFeedback;
+        syncTimeoutNs = static_cast<int64_t>(params_.syncTimeoutUs) * 1000;
+        feedbackAssembler_.setExpectedJoints(params_.feedbackJointMask);
+        periodNs = static_cast<int64_t>(std::max(params_.controlPeriodUs, 50)) * 1000;
+        trajectoryPeriodNs = static_cast<int64_t>(params_.trajectoryPeriodUs) * 1000;
+        supervisoryPeriodNs = static_cast<int64_t>(params_.supervisoryPeriodUs) * 1000;
+        fused = params_.fusedPipeline;
+    }
+    // 慢任务周期取不小于设定值的节拍整数倍
+    auto alignToTick = [periodNs](int64_t ns) {
+        return std::max<int64_t>(1, (ns + periodNs - 1) / periodNs) * periodNs;
+    };
+    trajectoryPeriodNs = alignToTick(trajectoryPeriodNs);
+    supervisoryPeriodNs = alignToTick(supervisoryPeriodNs);
+
+    feedbackAssembler_.resetStats();
+    uint64_t round = 0;  // 上一节拍下发指令的轮次
+
+    // 融合流水线：串口收发在本线程内完成；多线程流水线只有接收在其他线程，指令同样由本线程写出
+    const int fd = serialFd_.load();
+    std::unique_ptr<FusedSerialIo> io;
+    if (fused) {
+        if (fd >= 0) {
+            io = std::make_unique<FusedSerialIo>(fd, stateExchange_, &feedbackAssembler_);
+            emit logMessage(QStringLiteral("融合流水线已启用：串口收发、解析与控制在控制线程内完成"));
+        } else {
+            emit logMessage(QStringLiteral("未设置串口，融合流水线未启用"));
+        }
+    }
 
-    while (running_.load()) {
-        // 计算下一次唤醒时间
-        nextWakeTime += std::chrono::milliseconds(controlPeriodMs_);
+    // 定时模式按CLOCK_MONOTONIC绝对时刻唤醒，唤醒时刻不随计算耗时漂移
+    PeriodicTimer timer(periodNs);
+    stateAge_ = StateAgeStats();
+    int64_t lastTrajectoryNs = Clock::now();
+    int64_t trajectoryUpdateNs = lastTrajectoryNs;  // commandedJoint_的计算时刻
+    int64_t lastInnerNs = 0;                        // 上一次内环的时刻 (控制律的dt)
+    bool queueRun = false;  // 本次运行是否在执行运动队列
+    bool feedbackLost = false;
+    JointStateExchange::Versions consumed = stateExchange_.versions();
+    uint64_t feedbackCycles = 0;
+    uint64_t feedbackTimeouts = 0;
+    uint64_t commandWriteErrors = 0;
+    // 各关节最近一次写出的指令，由监控任务转发给界面显示 (索引1-3)
+    std::array<std::pair<float, float>, 4> lastCommand{};
+    std::array<int64_t, 4> lastCommandNs{};
+    std::array<int64_t, 4> shownCommandNs{};
+    auto currentStats = [&]() {
+        CycleStats stats = timer.stats();
+        stats.cycles += feedbackCycles + feedbackTimeouts;
+        stats.feedbackCycles = feedbackCycles;
+        stats.feedbackTimeouts = feedbackTimeouts;
+        return stats;
+    };
+
+    MultiRateScheduler scheduler(periodNs);
+
+    // 内环 (每个节拍)：读取实测状态，把轨迹设定按速度外推到本节拍，经控制律计算后下发指令
+    auto innerLoop = [&](int64_t) {
+        // 同步反馈：等上一轮指令的各关节回报到齐 (或超时) 再开始计算
+        FeedbackSnapshot snapshot;
+        const bool synced = syncFeedback && round > 0;
+        if (synced) {
+            feedbackAssembler_.waitForRound(round, Clock::now() + syncTimeoutNs, snapshot);
+        }
 
-        // 获取当前时间
-        float currentTime = getCurrentTime();
-        float elapsedTime = currentTime - startTime_;
+        // 读取各关节实测状态 (无锁快照)，记录其从串口接收到此刻的年龄；
+        // 同步模式下取本轮快照，超时未回报的关节才退回到各自最近一次的状态
+        const int64_t now = Clock::now();
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            if (synced && snapshot.reported(joint)) {
+                measured_[joint] = snapshot.joints[joint - 1];
+                stateAge_.add(now - measured_[joint].timestampNs);
+            } else if (stateExchange_.read(joint, measured_[joint])) {
+                stateAge_.add(now - measured_[joint].timestampNs);
+            } else {
+                ++stateAge_.missing;
+            }
+        }
 
-        // 检查是否超出轨迹时长
-        {
-            QMutexLocker locker(&paramsMutex_);
-            if (elapsedTime > params_.trajectory.duration) {
-                //这里增加发送0力矩的函数，确保机器人停止
-                emit logMessage(QStringLiteral("轨迹跟踪已完成，时长: %1秒").arg(elapsedTime, 0, 'f', 2));
-                emit controlStatusChanged(false);
-                running_.store(false);
-                break;
+        // 控制律：PD + 限幅 + 加加速度受限滤波，每个节拍每个关节一次；没有反馈的关节不下发
+        const float dt = static_cast<float>(Clock::toSeconds(lastInnerNs > 0 ? now - lastInnerNs : periodNs));
+        lastInnerNs = now;
+        if (commandValid_) {
+            const float hold = static_cast<float>(Clock::toSeconds(now - trajectoryUpdateNs));
+            jointSetpoint_ = commandedJoint_.position + commandedJoint_.velocity * hold;
+            for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+                if (measured_[joint].jointIndex != joint) {
+                    continue;
+                }
+                const std::pair<float, float> command =
+                    computeControl(joint, measured_[joint], jointSetpoint_, commandedJoint_.velocity, dt);
+                if (io) {
+                    io->sendCommand(joint, command.first, command.second);
+                } else if (fd >= 0) {
+                    // 直接在控制线程写串口，不经界面线程的事件循环
+                    CanFrameCodec::CommandFrame frame;
+                    CanFrameCodec::encodePosVel(joint, command.first, command.second, frame);
+                    if (::write(fd, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size())) {
+                        ++commandWriteErrors;
+                    }
+                }
+                lastCommand[joint] = command;
+                lastCommandNs[joint] = Clock::now();
             }
         }
-        // 获取预计算轨迹点（对应C#里的查表）
-        int index = static_cast<int>(elapsedTime / 0.001f);
+
+        // 本节拍指令在此下发，此后收到的反馈归入新一轮
+        if (syncFeedback) {
+            round = feedbackAssembler_.beginRound(Clock::now());
+        }
+    };
+
+    // 轨迹与前馈：推进轨迹时间，查表并换算出关节设定 (位置/速度/加速度)
+    auto trajectoryUpdate = [&](int64_t) {
+        // 按实际经过时间和速度倍率推进轨迹时间，与更新周期无关
+        // 轨迹时间以int64纳秒累加，倍率为1时无舍入；只在查表时才转成float
+        const int64_t now = Clock::now();
+        const int64_t dtWallNs = now - lastTrajectoryNs;
+        const float dtWall = static_cast<float>(Clock::toSeconds(dtWallNs));
+        lastTrajectoryNs = now;
+        const float timeScale = timeScale_.load(std::memory_order_relaxed);
+        trajectoryTimeNs_ += std::llround(static_cast<double>(dtWallNs) * timeScale);
+
+        // 在线重规划：切换轨迹源并从当前设定规划过渡段
+        if (applyPendingRetarget()) {
+            queueRun = false;
+        }
+        const float elapsedTime = static_cast<float>(Clock::toSeconds(trajectoryTimeNs_));
+
         TrajectoryPoint desiredPoint;
-        {
+        TrajectorySpace desiredSpace = TrajectorySpace::Cartesian;
+        if (motionQueue_->busy()) {
+            // 运动队列：各段连续衔接，跑到队列排空为止；
+            // 开始执行时从当前设定 (尚无设定时取实测) 重新构建各段，第一段不产生位置阶跃
+            Vector3f start;
+            if (!queueRun && currentCartesianPosition(start)) {
+                motionQueue_->rebase(start);
+            }
+            queueRun = true;
+            motionQueue_->step(dtWall * timeScale, desiredPoint);
+        } else if (queueRun) {
+            emit logMessage(QStringLiteral("运动队列已执行完毕，时长: %1秒").arg(elapsedTime, 0, 'f', 2));
+            running_.store(false);
+            return;
+        } else {
+            // 检查是否超出轨迹时长 (外部轨迹源的时长由表长决定)
             QMutexLocker locker(&modelMutex_);
-            if (!trajectoryGenerator_) continue;
-            desiredPoint = trajectoryGenerator_->getPrecomputedPoint(index);
+            if (!trajectoryGenerator_) return;
+            if (elapsedTime > trajectoryGenerator_->getDuration()) {
+                //这里增加发送0力矩的函数，确保机器人停止
+                emit logMessage(QStringLiteral("轨迹跟踪已完成，时长: %1秒").arg(elapsedTime, 0, 'f', 2));
+                running_.store(false);
+                return;
+            }
+            // 查询预计算轨迹（对应C#里的查表），采样点间插值
+            desiredPoint = trajectoryGenerator_->sample(elapsedTime, timeScale);
+            desiredSpace = trajectoryGenerator_->getPrecomputedTrajectory().space();
         }
 
-        
-
-
+        // 关节设定：过渡段期间取过渡段 (按倍率缩放速度/加速度，与查表一致)，否则由轨迹点换算
+        if (elapsedTime < 0.0f) {
+            commandedJoint_ = blend_.evaluate(elapsedTime + blendDuration_);
+            commandedJoint_.velocity *= timeScale;
+            commandedJoint_.acceleration *= timeScale * timeScale;
+        } else {
+            commandedJoint_ = toJointState(desiredPoint, desiredSpace, dtWall, timeScale);
+        }
+        trajectoryUpdateNs = now;
+        commandValid_ = true;
+    };
+
+    // 监控：反馈中断检测，发布统计 (读取方占用时跳过本次)
+    auto supervisory = [&](int64_t now) {
+        constexpr int64_t kFeedbackLossNs = 100 * Clock::kNsPerMs;
+        bool lost = false;
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            lost = lost || measured_[joint].jointIndex != joint || now - measured_[joint].timestampNs > kFeedbackLossNs;
+        }
+        if (lost != feedbackLost) {
+            feedbackLost = lost;
+            emit logMessage(lost ? QStringLiteral("关节反馈中断 (超过100ms未更新)") : QStringLiteral("关节反馈已恢复"));
+        }
 
+        // 指令只在监控周期内转发最近一次，界面线程的事件数与内环频率无关
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            if (lastCommandNs[joint] != shownCommandNs[joint]) {
+                shownCommandNs[joint] = lastCommandNs[joint];
+                emit controlCommandSent(joint, lastCommand[joint].first, lastCommand[joint].second,
+                                        lastCommandNs[joint]);
+            }
+        }
 
+        if (statsMutex_.tryLock()) {
+            cycleStats_ = currentStats();
+            rateStats_ = scheduler.stats();
+            statsMutex_.unlock();
+        }
+    };
+
+    // 同一节拍内按内环、轨迹、监控的顺序执行；监控错开一个节拍，轨迹周期长于节拍时不与其同拍
+    const int supervisoryPhase = supervisoryPeriodNs / periodNs > 1 ? 1 : 0;
+    scheduler.addTask("inner", periodNs, periodNs / 4, innerLoop);
+    scheduler.addTask("trajectory", trajectoryPeriodNs, periodNs / 2, trajectoryUpdate);
+    scheduler.addTask("supervisory", supervisoryPeriodNs, periodNs / 4, supervisory, supervisoryPhase);
+    {
+        QMutexLocker locker(&statsMutex_);
+        cycleStats_ = CycleStats();
+        rateStats_ = scheduler.stats();
+    }
+    emit logMessage(QStringLiteral("多速率调度: 内环%1us，轨迹%2us，监控%3us，最坏节拍预算%4us")
+                    .arg(periodNs / 1000)
+                    .arg(trajectoryPeriodNs / 1000)
+                    .arg(supervisoryPeriodNs / 1000)
+                    .arg(scheduler.worstTickBudget() / 1000));
 
+    timer.start();
+    while (running_.load()) {
+        const int64_t tickNs = Clock::now();
+        scheduler.tick(tickNs);
+        if (!running_.load()) {
+            break;
+        }
 
-        // 精确休眠到下一个控制周期
-        std::this_thread::sleep_until(nextWakeTime);
+        if (io) {
+            // 融合模式：等待期间直接收取并解析串口数据
+            if (trigger == CycleTrigger::Feedback) {
+                const int64_t deadline = tickNs + feedbackTimeoutNs;
+                bool fresh = false;
+                while (!fresh && Clock::now() < deadline) {
+                    io->poll(deadline);
+                    fresh = stateExchange_.waitForFreshSet(consumed, 0);  // 不等待，只检查
+                }
+                if (fresh) {
+                    ++feedbackCycles;
+                } else {
+                    ++feedbackTimeouts;
+                }
+            } else {
+                // 收到下一唤醒前kPollSlackNs为止，剩余时间交给定时器，唤醒统计不受影响
+                constexpr int64_t kPollSlackNs = 20 * 1000;
+                const int64_t pollUntil = timer.nextWakeNs() - kPollSlackNs;
+                while (Clock::now() < pollUntil) {
+                    io->poll(pollUntil);
+                }
+                timer.wait();
+            }
+        } else if (trigger == CycleTrigger::Feedback) {
+            // 全部关节都有新反馈即开始下一节拍；超时则以现有状态计算，不让控制停摆
+            if (stateExchange_.waitForFreshSet(consumed, tickNs + feedbackTimeoutNs)) {
+                ++feedbackCycles;
+            } else {
+                ++feedbackTimeouts;
+            }
+        } else {
+            // 休眠到下一个节拍
+            timer.wait();
+        }
     }
 
+    {
+        QMutexLocker locker(&statsMutex_);
+        cycleStats_ = currentStats();
+        rateStats_ = scheduler.stats();
+    }
+    if (io) {
+        const FusedSerialIo::Stats &ioStats = io->stats();
+        emit logMessage(QStringLiteral("融合流水线: 读取%1次，状态帧%2，其他帧%3，丢弃字节%4，指令%5 (写失败%6)")
+                        .arg(ioStats.reads)
+                        .arg(ioStats.frames)
+                        .arg(ioStats.otherFrames)
+                        .arg(ioStats.droppedBytes)
+                        .arg(ioStats.commands)
+                        .arg(ioStats.writeErrors));
+    } else if (commandWriteErrors > 0) {
+        emit logMessage(QStringLiteral("指令写串口失败%1次").arg(commandWriteErrors));
+    }
     emit controlStatusChanged(false);
 }
+
+CycleStats ControlWorker::cycleStats() const
+{
+    QMutexLocker locker(&statsMutex_);
+    return cycleStats_;
+}
+
+std::vector<MultiRateScheduler::RateStats> ControlWorker::rateStats() const
+{
+    QMutexLocker locker(&statsMutex_);
+    return rateStats_;
+}
 //界面按钮清除数据时调用，UI图清除，这里重置预定轨迹的起始运行索引
 void ControlWorker::clearMoveIndex()
 {
     moveIndex_.store(0);
+    trajectoryTimeNs_ = 0;
     emit logMessage(QStringLiteral("预定轨迹索引已重置"));
 }
 
-Eigen::Vector3f ControlWorker::computeDesiredTrajectory(float t) const
+void ControlWorker::setTimeScale(float scale)
+{
+    // 控制循环运行时该槽无法经事件队列送达，因此由RobotController直接调用
+    timeScale_.store(std::max(scale, 0.0f), std::memory_order_relaxed);
+}
+
+void ControlWorker::loadTrajectoryFile(const QString &path)
+{
+    std::string error;
+    bool ok = false;
+    float duration = 0.0f;
+    {
+        QMutexLocker locker(&modelMutex_);
+        if (trajectoryGenerator_) {
+            ok = trajectoryGenerator_->loadTrajectoryFile(path.toStdString(), &error);
+            duration = trajectoryGenerator_->getDuration();
+        }
+    }
+
+    if (ok) {
+        emit logMessage(QStringLiteral("已加载轨迹文件 %1，时长: %2秒").arg(path).arg(duration, 0, 'f', 3));
+    } else {
+        emit logMessage(QStringLiteral("加载轨迹文件失败: %1").arg(QString::fromStdString(error)));
+    }
+}
+
+void ControlWorker::retimeTimeOptimal()
+{
+    std::string error;
+    TimeOptimalParameterizer::Result result;
+    bool ok = false;
+    {
+        QMutexLocker locker(&modelMutex_);
+        if (trajectoryGenerator_) {
+            ok = trajectoryGenerator_->retimeTimeOptimal(topp_, &result, &error);
+        }
+    }
+
+    if (ok) {
+        emit logMessage(QStringLiteral("时间最优参数化完成，时长: %1秒 (速度受限点%2，力矩受限点%3)")
+                        .arg(result.duration, 0, 'f', 3)
+                        .arg(result.velocityLimitedPoints)
+                        .arg(result.torqueLimitedPoints));
+    } else {
+        emit logMessage(QStringLiteral("时间最优参数化失败: %1").arg(QString::fromStdString(error)));
+    }
+}
+
+bool ControlWorker::preflightCheck()
+{
+    // 运动队列按段在线生成，没有整表可查
+    if (motionQueue_->busy()) {
+        return true;
+    }
+
+    TrajectoryValidator::Report report;
+    {
+        QMutexLocker locker(&modelMutex_);
+        if (!trajectoryGenerator_ || !robotModel_) {
+            return true;
+        }
+        report = validator_.validate(trajectoryGenerator_->getPrecomputedTrajectory(), *robotModel_);
+    }
+
+    emit logMessage(QString::fromStdString(report.summary()));
+    return report.ok();
+}
+
+bool ControlWorker::queueMotion(const MotionSegment &segment)
+{
+    return motionQueue_->push(segment);
+}
+
+void ControlWorker::clearMotionQueue()
+{
+    // 停在当前设定点，下一段从这里出发
+    TrajectoryPoint current;
+    motionQueue_->step(0.0f, current);
+    motionQueue_->reset(current.position);
+}
+
+void ControlWorker::retarget(const TrajectoryStore &table)
+{
+    if (table.empty()) {
+        return;
+    }
+    if (!running_.load()) {
+        // 未运行：直接替换轨迹源，下次启动从新表起点开始
+        QMutexLocker locker(&modelMutex_);
+        trajectoryGenerator_->setExternalTrajectory(table);
+        return;
+    }
+    QMutexLocker locker(&retargetMutex_);
+    pendingTable_ = table;
+    retargetPending_ = true;
+}
+
+void ControlWorker::retargetGoal(const Vector3f &goal, TrajectorySpace space)
 {
+    // 单点表：过渡段结束即到达终点，控制循环随之结束
+    TrajectoryStore table;
+    table.resize(1, TrajectoryGenerator::kPrecomputeDt);
+    table.setSpace(space);
+    table.setPoint(0, TrajectoryPoint(goal, Vector3f::Zero(), Vector3f::Zero()));
+    retarget(table);
+}
+
+bool ControlWorker::applyPendingRetarget()
+{
+    TrajectoryStore table;
+    {
+        QMutexLocker locker(&retargetMutex_);
+        if (!retargetPending_) {
+            return false;
+        }
+        table = std::move(pendingTable_);
+        pendingTable_ = TrajectoryStore();
+        retargetPending_ = false;
+    }
+
     QMutexLocker locker(&modelMutex_);
+    const TrajectoryPoint target = jointStateAt(table, 0.0f);
 
-    Eigen::Vector3f desired = Eigen::Vector3f::Zero();
+    // 过渡段必须满足限幅，否则拒绝切换，继续执行当前轨迹
+    if (commandValid_ && !blend_.plan(commandedJoint_, target, blendLimits_)) {
+        emit logMessage(QStringLiteral("在线重规划被拒绝：%1秒内找不到满足速度/加速度/加加速度限幅的过渡段")
+                        .arg(TrajectoryBlend::kMaxDuration, 0, 'f', 0));
+        return false;
+    }
 
-    if (!trajectoryGenerator_ || !robotModel_) {
-        return desired;
+    // 运动队列让位于新轨迹，停在当前设定点
+    if (motionQueue_->busy()) {
+        clearMotionQueue();
     }
+    trajectoryGenerator_->setExternalTrajectory(table);
 
-    const TrajectoryParams &traj = params_.trajectory;
+    if (!commandValid_) {
+        trajectoryTimeNs_ = 0;
+        return true;
+    }
+    blendDuration_ = blend_.duration();
+    trajectoryTimeNs_ = -Clock::fromSeconds(blendDuration_);
+    emit logMessage(QStringLiteral("在线重规划：过渡段 %1ms").arg(blendDuration_ * 1000.0f, 0, 'f', 1));
+    return true;
+}
 
-    switch (traj.type) {
-    case TrajectoryType::Sine: {
-        // 正弦轨迹 (关节空间)
-        desired = trajectoryGenerator_->generateSineJointTrajectory(t);
-        break;
+bool ControlWorker::currentCartesianPosition(Vector3f &position) const
+{
+    Vector3f q;
+    if (commandValid_) {
+        q = commandedJoint_.position;
+    } else {
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            if (measured_[joint].jointIndex != joint) {
+                return false;  // 尚无反馈
+            }
+            q[joint - 1] = measured_[joint].position;
+        }
     }
-    case TrajectoryType::Spiral: {
-        // 螺旋线轨迹 (工作空间 -> 关节空间)
-        TrajectoryPoint workspacePoint = trajectoryGenerator_->generateSpiralPoint(t);
+    QMutexLocker locker(&modelMutex_);
+    return robotModel_ && robotModel_->forwardKinematics(q, position);
+}
 
-        // 通过逆运动学计算关节角度
-        Eigen::Vector3f position(workspacePoint.position[0],
-                                 workspacePoint.position[1],
-                                 workspacePoint.position[2]);
+TrajectoryPoint ControlWorker::jointStateAt(const TrajectoryStore &table, float t) const
+{
+    if (table.space() == TrajectorySpace::Joint) {
+        return table.sample(t);
+    }
 
-        Eigen::Vector3f q;
-        bool success = robotModel_->inverseKinematics(position, q);
-        if (success) {
-            desired = q;
-        } else {
-            // 逆运动学失败，使用默认位置
-            desired.setZero();
+    // 笛卡尔表：相邻三点逆解，差分得到关节速度和加速度
+    const float h = table.dt();
+    Vector3f q[3];
+    for (int k = 0; k < 3; ++k) {
+        if (!robotModel_->inverseKinematics(table.sample(t + k * h).position, q[k])) {
+            q[k] = k > 0 ? q[k - 1] : commandedJoint_.position;
         }
-        break;
     }
-    default:
-        // 未知轨迹类型，使用默认值
-        desired.setZero();
-        break;
+    return TrajectoryPoint(q[0], (q[1] - q[0]) / h, (q[2] - 2.0f * q[1] + q[0]) / (h * h));
+}
+
+TrajectoryPoint ControlWorker::toJointState(const TrajectoryPoint &point, TrajectorySpace space,
+                                           float dtWall, float timeScale)
+{
+    // 暂停 (倍率为0) 时设定点不动，不能沿用上一次的速度前馈
+    if (space == TrajectorySpace::Joint) {
+        return timeScale > 0.0f ? point : TrajectoryPoint(point.position, Vector3f::Zero(), Vector3f::Zero());
     }
 
-    return desired;
+    Vector3f q;
+    {
+        QMutexLocker locker(&modelMutex_);
+        if (!robotModel_->inverseKinematics(point.position, q)) {
+            q = commandedJoint_.position;  // 逆解失败时保持上一设定
+        }
+    }
+    if (!commandValid_ || timeScale <= 0.0f) {
+        return TrajectoryPoint(q, Vector3f::Zero(), Vector3f::Zero());
+    }
+    if (dtWall <= 1e-6f) {
+        return TrajectoryPoint(q, commandedJoint_.velocity, Vector3f::Zero());
+    }
+    // 按墙钟时间差分：轨迹时间已含倍率，得到的就是实际关节速度
+    const Vector3f qd = (q - commandedJoint_.position) / dtWall;
+    return TrajectoryPoint(q, qd, (qd - commandedJoint_.velocity) / dtWall);
 }
 
 std::pair<float, float> ControlWorker::computeControl(
     int jointIndex,
     const JointState &state,
-    const Eigen::Vector3f& desired) const
+    const Eigen::Vector3f& desired,
+    const Eigen::Vector3f& desiredVelocity,
+    float dt)
 {
     QMutexLocker locker(&paramsMutex_);
 
     // 获取期望位置和速度
     // jointIndex: 1-3 对应 desired[0]-[2]
-    float desiredPos = (jointIndex >= 1 && jointIndex <= 3) ? desired[jointIndex-1] : 0.0f;
-    float desiredVel = 0.0f;  // 可以根据需要计算期望速度
+    const bool valid = jointIndex >= 1 && jointIndex <= 3;
+    float desiredPos = valid ? desired[jointIndex-1] : 0.0f;
+    float desiredVel = valid ? desiredVelocity[jointIndex-1] : 0.0f;  // 轨迹速度作前馈
 
     // 计算位置误差
     float posError = desiredPos - state.position;
@@ -204,20 +714,27 @@ std::pair<float, float> ControlWorker::computeControl(
     targetPos = std::clamp(targetPos, -MAX_POS, MAX_POS);
     targetVel = std::clamp(targetVel, -MAX_VEL, MAX_VEL);
 
-    return {targetPos, targetVel};
-}
-
+    // 加加速度受限的设定点滤波：目标跳变时下发的指令仍平滑连续
+    const int axis = jointIndex - 1;
+    if (axis < 0 || axis > 2) {
+        return {targetPos, targetVel};
+    }
+    if (!commandFilter_.initialized(axis)) {
+        commandFilter_.reset(axis, state.position, state.velocity);
+    }
+    const OnlineTrajectoryFilter::AxisState &command = commandFilter_.update(axis, targetPos, targetVel, dt);
 
-float ControlWorker::getCurrentTime() const
-{
-    return static_cast<float>(QDateTime::currentMSecsSinceEpoch()) / 1000.0f;
+    return {command.position, command.velocity};
 }
 
+
 ///////////////////////////// RobotController 实现 /////////////////////////////
 
 RobotController::RobotController(QObject *parent)
     : QObject(parent)
 {
+    qRegisterMetaType<JointState>("JointState");
+
     // 创建控制线程和工作对象
     controlThread_ = new QThread(this);
     worker_ = new ControlWorker();
@@ -226,10 +743,14 @@ RobotController::RobotController(QObject *parent)
     worker_->moveToThread(controlThread_);
 
     // 连接信号槽
+    // 指令由控制线程直接写串口，这里只转发给界面显示
     connect(worker_, &ControlWorker::controlCommandSent,
-            this, &RobotController::onControlCommandSent);
-    connect(worker_, &ControlWorker::controlStatusChanged,
-            this, &RobotController::controlStatusChanged);
+            this, &RobotController::controlCommandSent);
+    // 控制循环结束或拒绝启动时同步运行标志，isControlRunning()不再停留在true
+    connect(worker_, &ControlWorker::controlStatusChanged, this, [this](bool running) {
+        controlRunning_.store(running);
+        emit controlStatusChanged(running);
+    });
     connect(worker_, &ControlWorker::logMessage,
             this, &RobotController::logMessage);
 
@@ -258,20 +779,22 @@ RobotController::~RobotController()
 void RobotController::setSerialPort(SerialPort *serialPort)
 {
     serialPort_ = serialPort;
+    if (worker_) {
+        worker_->setSerialFd(serialPort ? serialPort->fd() : -1);
+    }
 }
 
-void RobotController::updateJointState(int jointIndex, float position, float velocity)
+void RobotController::updateJointState(int jointIndex, float position, float velocity, qint64 rxTimeNs)
 {
     if (!worker_) {
         return;
     }
 
-    JointState state(jointIndex, position, velocity, getCurrentTime());
+    // 优先使用串口接收时刻，直接调用 (无接收时间戳) 时取当前时刻
+    JointState state(jointIndex, position, velocity, rxTimeNs > 0 ? rxTimeNs : Clock::now());
 
-    // 转发到工作线程
-    QMetaObject::invokeMethod(worker_, "updateJointState",
-                             Qt::QueuedConnection,
-                             Q_ARG(JointState, state));
+    // 直接写入交换区：控制循环阻塞在start()中，排队事件在运行期间不会被处理
+    worker_->updateJointState(state);
 
     // 同时发送状态更新信号
     emit jointStateChanged(state);
@@ -342,6 +865,79 @@ void RobotController::initTrajectoryTracking()
     }
 }
 
+void RobotController::loadTrajectoryFile(const QString &path)
+{
+    if (worker_) {
+        QMetaObject::invokeMethod(worker_, "loadTrajectoryFile",
+                                 Qt::QueuedConnection,
+                                 Q_ARG(QString, path));
+    }
+}
+
+void RobotController::setTimeScale(float scale)
+{
+    if (worker_) {
+        worker_->setTimeScale(scale);  // 原子量，可跨线程直接写
+    }
+    emit logMessage(QStringLiteral("速度倍率: %1").arg(scale, 0, 'f', 2));
+}
+
+void RobotController::retimeTimeOptimal()
+{
+    if (worker_) {
+        QMetaObject::invokeMethod(worker_, "retimeTimeOptimal", Qt::QueuedConnection);
+    }
+}
+
+bool RobotController::queueMotion(const MotionSegment &segment)
+{
+    // 队列自带锁，直接调用 (控制循环运行时事件队列不会被处理)
+    const bool ok = worker_ && worker_->queueMotion(segment);
+    if (!ok) {
+        emit logMessage(QStringLiteral("运动段无效，未加入队列"));
+    }
+    return ok;
+}
+
+void RobotController::clearMotionQueue()
+{
+    if (worker_) {
+        worker_->clearMotionQueue();
+    }
+}
+
+void RobotController::retargetTrajectory(const TrajectoryParams &params)
+{
+    if (!worker_) {
+        return;
+    }
+    // 在调用线程生成新表，控制线程只做过渡段规划和切换
+    TrajectoryGenerator generator(params);
+    worker_->retarget(generator.getPrecomputedTrajectory());
+}
+
+void RobotController::retargetGoal(const Vector3f &goal, TrajectorySpace space)
+{
+    if (worker_) {
+        worker_->retargetGoal(goal, space);
+    }
+}
+
+CycleStats RobotController::cycleStats() const
+{
+    return worker_ ? worker_->cycleStats() : CycleStats();
+}
+
+std::vector<MultiRateScheduler::RateStats> RobotController::rateStats() const
+{
+    return worker_ ? worker_->rateStats() : std::vector<MultiRateScheduler::RateStats>();
+}
+
+FeedbackSyncStats RobotController::feedbackSyncStats() const
+{
+    return worker_ ? worker_->feedbackSyncStats() : FeedbackSyncStats();
+}
+
 void RobotController::enableMotors()
 {
     if (!serialPort_) {
@@ -402,48 +998,9 @@ void RobotController::disableMotors()
 
 JointState RobotController::getJointState(int jointIndex) const
 {
-    return JointState();
-}
-
-void RobotController::onControlCommandSent(int jointIndex, float targetPos, float targetVel)
-{
-    if (!serialPort_) {
-        return;
+    JointState state;
+    if (worker_) {
+        worker_->stateExchange().read(jointIndex, state);
     }
-
-    // 构造CAN帧（根据达妙电机协议）
-    int canId = (jointIndex == 3) ? 0x03 : jointIndex;
-    uint32_t canIdWithMode = canId + 0x100;  // 位置速度控制模式
-
-    uint8_t head[21] = {0x55, 0xaa, 0x1e, 0x01, 0x01, 0x00, 0x00, 0x00,
-                        0x0a, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
-                        0x00, 0x00, 0x08, 0x00, 0x00};
-
-    uint8_t frame[30];
-    memset(frame, 0, 30);
-    memcpy(frame, head, 21);
-
-    // 写入CAN ID (little-endian)
-    frame[13] = canIdWithMode & 0xFF;
-    frame[14] = (canIdWithMode >> 8) & 0xFF;
-    frame[15] = (canIdWithMode >> 16) & 0xFF;
-    frame[16] = (canIdWithMode >> 24) & 0xFF;
-
-    // 写入位置（float）
-    memcpy(frame + 21, &targetPos, sizeof(float));
-
-    // 写入速度（float）
-    memcpy(frame + 25, &targetVel, sizeof(float));
-
-    // 发送
-    serialPort_->send(frame, 30);
-
-    // 转发信号给MainWindow
-    emit controlCommandSent(jointIndex, targetPos, targetVel);
-}
-
-float RobotController::getCurrentTime() const
-{
-    return static_cast<float>(QDateTime::currentMSecsSinceEpoch()) / 1000.0f;
+    return state;
 }
-
@@ -14,9 +14,19 @@
 #include "robot_common.h"
 #include "robot_model.h"
 #include "trajectory_generator.h"
+#include "motion_queue.h"
+#include "trajectory_blend.h"
+#include "online_trajectory_filter.h"
+#include "trajectory_validator.h"
+#include "realtime_runtime.h"
+#include "state_exchange.h"
+#include "multirate_scheduler.h"
 
 class SerialPort;
 
+// jointStateChanged 从CAN解析线程发出，跨线程排队需要注册类型
+Q_DECLARE_METATYPE(JointState)
+
 
 /**
  * @brief 控制工作线程（独立线程执行控制算法）
@@ -31,28 +41,92 @@ public:
 public slots:
     void start();
     void stop();
-    void updateJointState(const JointState &state);
     void setControlParams(const ControlParams &params);
     void initTrajectory();
     void clearMoveIndex();
+    void loadTrajectoryFile(const QString &path);
+    void setTimeScale(float scale);
+    void retimeTimeOptimal();
+
+public:
+    /**
+     * @brief 发布关节状态 (线程安全，由CAN解析线程直接调用，不经过事件循环)
+     */
+    void updateJointState(const JointState &state)
+    {
+        stateExchange_.publish(state);
+        feedbackAssembler_.publish(state);
+    }
+
+    const JointStateExchange &stateExchange() const { return stateExchange_; }
+
+    /**
+     * @brief 融合流水线使用的串口 (-1表示无串口)，控制循环启动时读取
+     */
+    void setSerialFd(int fd) { serialFd_.store(fd); }
+
+    /**
+     * @brief 按指令轮次的反馈同步统计 (线程安全)
+     */
+    FeedbackSyncStats feedbackSyncStats() const { return feedbackAssembler_.stats(); }
+
+    /**
+     * @brief 追加运动段 (线程安全，控制循环运行时也可直接调用)
+     *
+     * 队列非空时控制循环按队列执行，直到队列排空才结束本次运行。
+     */
+    bool queueMotion(const MotionSegment &segment);
+    void clearMotionQueue();
+
+    /**
+     * @brief 在线切换到新轨迹表 (线程安全)
+     *
+     * 运行中时，下一个控制周期从当前下发的关节状态规划一段加加速度受限的
+     * 五次过渡段，衔接到新表起点后继续按新表执行 (过渡段无法满足限幅时拒绝切换并记录日志)；
+     * 未运行时直接替换轨迹源。
+     */
+    void retarget(const TrajectoryStore &table);
+
+    /**
+     * @brief 在线切换到新目标点 (平滑过渡并停在目标处)
+     * @param goal 目标位置 (笛卡尔m 或 关节rad)
+     */
+    void retargetGoal(const Vector3f &goal, TrajectorySpace space);
+
+    /**
+     * @brief 控制周期统计快照 (线程安全，运行中由监控任务定期更新)
+     */
+    CycleStats cycleStats() const;
+
+    /**
+     * @brief 多速率调度各任务的耗时统计 (线程安全，运行中由监控任务定期更新)
+     */
+    std::vector<MultiRateScheduler::RateStats> rateStats() const;
 
 signals:
-    void controlCommandSent(int jointIndex, float targetPos, float targetVel);
+    void controlCommandSent(int jointIndex, float targetPos, float targetVel, qint64 sentNs);  // 监控周期内各关节最近一次指令，sentNs: 写出时刻
     void controlStatusChanged(bool running);
     void logMessage(const QString &message);
 
 private:
     void controlLoop();
-    Eigen::Vector3f computeDesiredTrajectory(float t) const;
     std::pair<float, float> computeControl(int jointIndex,
                                           const JointState &state,
-                                          const Eigen::Vector3f& desired) const;
-    float getCurrentTime() const;
-    void updateModelFromParams();  // 根据params_更新模型和生成器
+                                          const Eigen::Vector3f& desired,
+                                          const Eigen::Vector3f& desiredVelocity,
+                                          float dt);
+    bool updateModelFromParams();  // 根据params_更新模型和生成器，返回是否因轨迹参数变化放弃了外部轨迹源
+    bool applyPendingRetarget();   // 控制线程中执行待处理的重规划
+    bool preflightCheck();         // 启动前检查当前轨迹表，有阻止执行的违例时返回false
+    bool currentCartesianPosition(Vector3f &position) const;  // 当前关节设定 (无设定时取实测) 的末端位置
+    TrajectoryPoint jointStateAt(const TrajectoryStore &table, float t) const;  // 需持有modelMutex_
+    TrajectoryPoint toJointState(const TrajectoryPoint &point, TrajectorySpace space, float dtWall, float timeScale);
 
 private:
-    std::array<JointState, 4> jointStates_;  // 索引1-3对应关节1-3
-    mutable QMutex stateMutex_;  // 保护关节状态
+    JointStateExchange stateExchange_;       // CAN解析线程写，控制循环读 (seqlock)
+    FeedbackAssembler feedbackAssembler_;    // 按指令轮次组装的一致快照 (syncFeedback时使用)
+    std::array<JointState, 4> measured_;     // 本周期开始时读取的实测状态，索引1-3对应关节1-3 (仅控制线程)
+    StateAgeStats stateAge_;                 // 实测状态在使用时刻的年龄 (仅控制线程)
     ControlParams params_;
     mutable QMutex paramsMutex_;  // 保护参数
 
@@ -63,8 +137,29 @@ private:
 
     std::atomic_bool running_{false};
     std::atomic_bool trajectoryInitialized_{false};
-    float startTime_ = 0.0f;
-    int controlPeriodMs_ = 1;
+    std::atomic_int serialFd_{-1};
+    int64_t startTimeNs_ = 0;              // 本次运行起始时刻 (Clock::now())
+    int64_t trajectoryTimeNs_ = 0;         // 轨迹时间 (ns，按时间缩放积分)
+    std::atomic<float> timeScale_{1.0f};   // 运行时速度倍率
+    TimeOptimalParameterizer topp_;        // 默认按DM4310限幅
+    TrajectoryValidator validator_;        // 启动前整表预检，默认按DM4310限幅
+    mutable QMutex statsMutex_;            // 控制线程只tryLock，不会因读取方阻塞
+    CycleStats cycleStats_;
+    std::vector<MultiRateScheduler::RateStats> rateStats_;
+    std::unique_ptr<MotionQueue> motionQueue_;  // 自带锁，可跨线程入队
+
+    // 在线重规划：trajectoryTimeNs_ < 0 时处于过渡段，过渡段结束即进入新表
+    QMutex retargetMutex_;
+    bool retargetPending_ = false;
+    TrajectoryStore pendingTable_;
+    TrajectoryBlend blend_;
+    TrajectoryBlend::Limits blendLimits_;
+    float blendDuration_ = 0.0f;
+    TrajectoryPoint commandedJoint_;  // 最近一次轨迹更新的关节设定 (位置/速度/加速度)
+    Vector3f jointSetpoint_ = Vector3f::Zero();  // 内环设定：commandedJoint_按速度外推到当前节拍
+    bool commandValid_ = false;
+
+    OnlineTrajectoryFilter commandFilter_;  // 下发指令的加加速度限制 (控制线程独占)
 
     std::atomic_int moveIndex_{0};  // 预定义轨迹点的起始索引
 };
@@ -90,7 +185,7 @@ public:
     /**
      * @brief 更新关节状态（由CAN解析线程调用）
      */
-    void updateJointState(int jointIndex, float position, float velocity);
+    void updateJointState(int jointIndex, float position, float velocity, qint64 rxTimeNs = 0);
 
     /**
      * @brief 启动控制循环
@@ -122,6 +217,57 @@ public:
      */
     void initTrajectoryTracking();
 
+    /**
+     * @brief 加载二进制轨迹文件作为轨迹源 (mmap零拷贝)
+     */
+    void loadTrajectoryFile(const QString &path);
+
+    /**
+     * @brief 设置运行时速度倍率 (无需重新生成轨迹)
+     */
+    void setTimeScale(float scale);
+
+    /**
+     * @brief 按电机速度/力矩限幅对当前路径做时间最优参数化
+     */
+    void retimeTimeOptimal();
+
+    /**
+     * @brief 追加运动段 (直线/圆弧/螺旋/样条)，多段之间按前瞻规划连续衔接
+     * @return 段参数是否有效
+     */
+    bool queueMotion(const MotionSegment &segment);
+
+    /**
+     * @brief 清空运动队列
+     */
+    void clearMotionQueue();
+
+    /**
+     * @brief 运行中切换到按新参数生成的轨迹，从当前状态平滑过渡，无需停止重启
+     */
+    void retargetTrajectory(const TrajectoryParams &params);
+
+    /**
+     * @brief 运行中切换到新目标点，平滑过渡后停在目标处
+     */
+    void retargetGoal(const Vector3f &goal, TrajectorySpace space = TrajectorySpace::Cartesian);
+
+    /**
+     * @brief 控制周期统计 (超时次数、唤醒延迟、最长计算耗时)
+     */
+    CycleStats cycleStats() const;
+
+    /**
+     * @brief 多速率调度各任务 (内环/轨迹/监控) 的耗时统计
+     */
+    std::vector<MultiRateScheduler::RateStats> rateStats() const;
+
+    /**
+     * @brief 反馈同步统计 (各关节缺失次数、迟到帧、轮内最大接收时差)
+     */
+    FeedbackSyncStats feedbackSyncStats() const;
+
     /**
      * @brief 使能电机
      */
@@ -149,9 +295,9 @@ signals:
     void jointStateChanged(const JointState &state);
 
     /**
-     * @brief 控制命令发送信号（用于调试/显示）
+     * @brief 控制命令发送信号（仅用于调试/显示，按监控周期转发），timestampNs为串口发送时刻
      */
-    void controlCommandSent(int jointIndex, float targetPos, float targetVel);
+    void controlCommandSent(int jointIndex, float targetPos, float targetVel, qint64 timestampNs);
 
     /**
      * @brief 控制循环状态变化
@@ -163,18 +309,6 @@ signals:
      */
     void logMessage(const QString &message);
 
-public slots:
-    /**
-     * @brief 内部槽：处理控制命令发送
-     */
-    void onControlCommandSent(int jointIndex, float targetPos, float targetVel);
-
-private:
-    /**
-     * @brief 获取当前时间（秒）
-     */
-    float getCurrentTime() const;
-
 private:
     SerialPort *serialPort_ = nullptr;
     ControlWorker *worker_ = nullptr;
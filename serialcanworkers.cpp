@@ -1,110 +1,125 @@
 #include "serialcanworkers.h"
 
-#include <QMutexLocker>
 #include <QThread>
 
 #include <algorithm>
+#include <time.h>
+
+namespace {
+
+// 线程CPU时间 (纳秒)
+int64_t threadCpuNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * Clock::kNsPerSec + ts.tv_nsec;
+}
+
+QString rxModeName(SerialPort::RxMode mode)
+{
+    switch (mode) {
+    case SerialPort::RxMode::BusyPoll:
+        return QStringLiteral("忙轮询");
+    case SerialPort::RxMode::Blocking:
+        return QStringLiteral("阻塞读 (VMIN/VTIME)");
+    case SerialPort::RxMode::Select:
+        break;
+    }
+    return QStringLiteral("select");
+}
+
+} // namespace
+
 //////////////////////////////////SerialRxWorker class Start////////////////////////////////////////
-SerialRxWorker::SerialRxWorker(SerialPort *serial, FIFO *canRxFifo, FIFO *uartRxFifo,
-                               QMutex *canMutex, QMutex *uartMutex,
-                               QWaitCondition *canDataReady,
-                               QObject *parent)
+SerialRxWorker::SerialRxWorker(SerialPort *serial, CanRxQueue *canRxQueue,
+                               SpscRing<uint8_t> *uartRxQueue, QObject *parent)
     : QObject(parent)
     , serial_(serial)
-    , canRxFifo_(canRxFifo)
-    , uartRxFifo_(uartRxFifo)
-    , canMutex_(canMutex)
-    , uartMutex_(uartMutex)
-    , canDataReady_(canDataReady)
+    , canRxQueue_(canRxQueue)
+    , uartRxQueue_(uartRxQueue)
 {
 }
 
 void SerialRxWorker::start()
 {
-    if (!serial_ || !canRxFifo_ || !uartRxFifo_ || !canMutex_ || !uartMutex_) {
+    if (!serial_ || !canRxQueue_ || !uartRxQueue_) {
         emit logMessage(QStringLiteral("串口接收线程启动失败：依赖为空"));
         return;
     }
 
     running_.store(true);
-    emit logMessage(QStringLiteral("串口接收线程已启动"));
+    TraceLog::instance().registerThread();  // 首条跟踪记录不再分配内存
+    emit logMessage(QStringLiteral("串口接收线程已启动，接收方式: %1").arg(rxModeName(serial_->rx_mode())));
 
-    std::vector<uint8_t> streamBuf;
-    streamBuf.reserve(512);
+    // 串口数据直接读进帧环形缓冲区，帧在缓冲区内就地提取
+    CanFrameRing ring;
 
-    uint8_t recvBuf[64];
+    // 接收统计：读到数据/空返回/出错的次数，线程CPU时间占墙钟时间的比例
+    uint64_t reads = 0;
+    uint64_t emptyReads = 0;
+    uint64_t errors = 0;
+    uint64_t bytes = 0;
+    const int64_t wallStartNs = Clock::now();
+    const int64_t cpuStartNs = threadCpuNs();
 
     while (running_.load())
     {
-        const ssize_t recvLen = serial_->recv(recvBuf, sizeof(recvBuf));
+        uint8_t *recvPtr = ring.writePtr();   // 先整理缓冲区，再取可写长度
+        const ssize_t recvLen = serial_->recv(recvPtr, ring.writable());
 
-        if (recvLen <= 0) {
+        if (recvLen < 0) {
+            // 出错时稍等，避免空转；超时返回0时recv内部已经等待过，不再额外休眠
+            ++errors;
             QThread::msleep(1);
             continue;
         }
+        if (recvLen == 0) {
+            ++emptyReads;
+            continue;
+        }
+        ++reads;
+        bytes += static_cast<uint64_t>(recvLen);
+        // 本次读到的数据中完成的帧都以此刻为接收时间
+        const int64_t rxTimeNs = Clock::now();
 
-        streamBuf.insert(streamBuf.end(), recvBuf, recvBuf + recvLen);
+        ring.commit(static_cast<size_t>(recvLen));
 
-        while (true)
+        CanFrameRing::View view;
+        ExtractResult result;
+        while ((result = ring.next(view)) != ExtractResult::NeedMoreData)
         {
-            std::array<uint8_t,16> canFrame{};
-            auto result = tryExtractCanFrame(streamBuf, canFrame);
-
             if (result == ExtractResult::GotFrame)
             {
-                uint8_t frameType = canFrame[1];
-
                 // 只保留状态帧
                 // AA 12 08 01 00 00 00 FF FF FF FF FF FF FF FD 55 ACK帧
                 // AA 11 08 00 00 00 00 01 7F FF 7F F7 FF 1B 19 55 状态帧
-                if (frameType != 0x11)
+                if (!CanFrameCodec::isStatusFrame(view.data))
                 {
-                    // 如果想调试可以打印
-                    emit logMessage("ACK filtered");
+                    // 如果想调试可以把跟踪级别设为debug
+                    TRACE_EVENT(TraceLevel::Debug, TraceEvent::AckFiltered, view.data, view.size);
                     continue;
                 }
-                QMutexLocker canLock(canMutex_);
-                canRxFifo_->WriteBuffer(canFrame.data(), 0, 16);
-                canDataReady_->wakeOne();  // 唤醒消费者
-            }
-            else if (result == ExtractResult::NeedMoreData)
-            {
-                // 半帧，绝不能动buffer
-                break;
+                CanRxRecord record;
+                std::copy(view.data, view.data + CanFrameCodec::kFrameLength, record.frame.begin());
+                record.rxTimeNs = rxTimeNs;
+                // 队列满时按溢出策略处理；解析线程在休眠时由push唤醒
+                canRxQueue_->push(record);
             }
-            else // NoFrame
+            else // NoFrame：AA前面的 (以及假帧头开始的) 才是UART
             {
-                auto headIter = std::find(streamBuf.begin(), streamBuf.end(), 0xAA);
-
-                if (headIter == streamBuf.end())
-                {
-                    if (!streamBuf.empty())
-                    {
-                        QMutexLocker uartLock(uartMutex_);
-                        uartRxFifo_->WriteBuffer(streamBuf.data(),
-                                                 0,
-                                                 static_cast<int>(streamBuf.size()));
-                        streamBuf.clear();
-                    }
-                }
-                else if (headIter != streamBuf.begin())
-                {
-                    // AA前面的才是UART
-                    size_t uartLen = std::distance(streamBuf.begin(), headIter);
-
-                    QMutexLocker uartLock(uartMutex_);
-                    uartRxFifo_->WriteBuffer(streamBuf.data(),
-                                             0,
-                                             static_cast<int>(uartLen));
-
-                    streamBuf.erase(streamBuf.begin(), headIter);
-                }
-
-                break;
+                uartRxQueue_->pushBatch(view.data, view.size);
             }
         }
     }
 
+    const int64_t wallNs = std::max<int64_t>(1, Clock::now() - wallStartNs);
+    const int64_t cpuNs = threadCpuNs() - cpuStartNs;
+    emit logMessage(QStringLiteral("串口接收统计: 读取%1次 (平均%2字节)，空返回%3次，出错%4次，CPU占用%5%")
+                    .arg(reads)
+                    .arg(reads > 0 ? static_cast<double>(bytes) / reads : 0.0, 0, 'f', 1)
+                    .arg(emptyReads)
+                    .arg(errors)
+                    .arg(100.0 * cpuNs / wallNs, 0, 'f', 1));
     emit logMessage(QStringLiteral("串口接收线程已停止"));
 }
 
@@ -113,164 +128,94 @@ void SerialRxWorker::start()
 void SerialRxWorker::stop()
 {
     running_.store(false);
-}
-SerialRxWorker::ExtractResult SerialRxWorker::tryExtractCanFrame(std::vector<uint8_t> &streamBuf,
-                                   std::array<uint8_t, 16> &canFrame) const
-{
-    constexpr uint8_t HEAD = 0xAA;
-    constexpr uint8_t TAIL = 0x55;
-    constexpr size_t FRAME_LEN = 16;
-
-    auto headIter = std::find(streamBuf.begin(), streamBuf.end(), HEAD);
-
-    // 没有帧头 → 全是UART数据
-    if (headIter == streamBuf.end())
-    {
-        return ExtractResult::NoFrame;
-    }
-
-    size_t headPos = std::distance(streamBuf.begin(), headIter);
-
-    // 帧不完整
-    if (streamBuf.size() - headPos < FRAME_LEN)
-    {
-        return ExtractResult::NeedMoreData;
-    }
-
-    // 完整帧判断
-    if (*(headIter + FRAME_LEN - 1) == TAIL)
-    {
-        std::copy(headIter,
-                  headIter + FRAME_LEN,
-                  canFrame.begin());
-
-        streamBuf.erase(streamBuf.begin(), headIter + FRAME_LEN);
-        return ExtractResult::GotFrame;
+    // 阻塞接收时poll没有超时，写eventfd唤醒
+    if (serial_ && serial_->rx_mode() == SerialPort::RxMode::Blocking) {
+        serial_->interrupt_reader();
     }
-
-    // 假帧头
-    streamBuf.erase(streamBuf.begin(), headIter + 1);
-    return ExtractResult::NoFrame;
 }
 //////////////////////////////////SerialRxWorker class end////////////////////////////////////////
 
 //////////////////////////////////CanParserWorker class Satrt////////////////////////////////////////
 
-CanParserWorker::CanParserWorker(FIFO *canRxFifo, QMutex *canMutex,
-                                 QWaitCondition *canDataReady,
-                                 QObject *parent)
+CanParserWorker::CanParserWorker(CanRxQueue *canRxQueue, QObject *parent)
     : QObject(parent)
-    , canRxFifo_(canRxFifo)
-    , canMutex_(canMutex)
-    , canDataReady_(canDataReady)
+    , canRxQueue_(canRxQueue)
 {
 }
 
 void CanParserWorker::start()
 {
-    if (!canRxFifo_ || !canMutex_ || !canDataReady_) {
+    if (!canRxQueue_) {
         emit logMessage(QStringLiteral("CAN解析线程启动失败：依赖为空"));
         return;
     }
 
     running_.store(true);
+    TraceLog::instance().registerThread();  // 首条跟踪记录不再分配内存
     emit logMessage(QStringLiteral("CAN解析线程已启动"));
 
-    std::array<unsigned char, 16> frame{};
+    // 一次取出队列中已有的全部记录 (最多kMaxBatch条)，逐条解码后每个关节只发布本批最新的状态
+    CanRxRecord records[kMaxBatch];
+    JointStateBatch batch;
+    uint64_t batches = 0;
+    uint64_t frames = 0;
     while (running_.load()) {
-        bool hasFrame = false;
-        {
-            QMutexLocker locker(canMutex_);
-            // 等待数据就绪，使用条件变量阻塞
-            while (canRxFifo_->GetDataCount() < 16 && running_.load()) {
-                canDataReady_->wait(canMutex_);
-            }
-            if (!running_.load()) {
-                break;
-            }
-            canRxFifo_->ReadBuffer(frame.data(), 0, 16);
-            canRxFifo_->Clear(16);
-            hasFrame = true;
-        }
-
-        if (!hasFrame) {
+        const size_t count = canRxQueue_->popBatch(records, static_cast<size_t>(batchSize_.load()));
+        if (count == 0) {
+            // 队列为空时在futex上休眠，接收线程写入或stop()时唤醒
+            canRxQueue_->waitForData(100 * Clock::kNsPerMs);
             continue;
         }
 
-        QString frameStr = "CAN Frame: ";
-
-        for (int i = 0; i < 16; i++)
-        {
-            frameStr += QString("%1 ").arg(frame[i], 2, 16, QLatin1Char('0')).toUpper();
+        batch.clear();
+        for (size_t i = 0; i < count; ++i) {
+            // 原样记录帧内容 (调试级别，关闭时几乎无开销，由跟踪日志线程格式化)
+            TRACE_EVENT(TraceLevel::Debug, TraceEvent::CanFrame, records[i].frame.data(), records[i].frame.size());
+            batch.add(records[i]);
         }
 
-        emit logMessage(frameStr);
-
-        const uint8_t motorId = frame[7];
-        float pos = byt2Float(frame[8], frame[9],MotorField::Pos);
-        float vel = byt2Float(frame[10], frame[11],MotorField::Vel);
-
-        int jointIndex = -1;
-        if (motorId == 17) {
-            jointIndex = 1;
-        } else if (motorId == 18) {
-            jointIndex = 2;
-        } else if (motorId == 19) {
-            jointIndex = 3;
-            pos = -pos;
-            vel = -vel;
+        if (batch.unknown > 0) {
+            emit logMessage(QStringLiteral("CAN解析收到未知电机ID: %1 (本批%2帧)")
+                            .arg(batch.lastUnknownMotor)
+                            .arg(batch.unknown));
         }
-        if (jointIndex > 0) {
-            emit jointStateUpdated(jointIndex, pos, vel);
-        } else {
-            emit logMessage(QStringLiteral("CAN解析收到未知电机ID: %1").arg(motorId));
+        for (int joint = 1; joint <= JointStateExchange::kJointCount; ++joint) {
+            if (batch.has(joint)) {
+                const JointState &state = batch.latest[joint];
+                emit jointStateUpdated(state.jointIndex, state.position, state.velocity, state.timestampNs);
+            }
         }
+        ++batches;
+        frames += count;
     }
 
+    emit logMessage(QStringLiteral("CAN解析统计: %1帧，%2批 (平均每批%3帧)")
+                    .arg(frames)
+                    .arg(batches)
+                    .arg(batches > 0 ? static_cast<double>(frames) / batches : 0.0, 0, 'f', 2));
+    const CanRxQueue::Stats queueStats = canRxQueue_->stats();
+    emit logMessage(QStringLiteral("CAN接收队列 (%1): 写入%2条，溢出%3次，丢弃%4条，被新状态取代%5条，最高占用%6/%7")
+                    .arg(QString::fromLatin1(CanRxQueue::policyName(canRxQueue_->policy())))
+                    .arg(queueStats.pushed)
+                    .arg(queueStats.overflows)
+                    .arg(queueStats.dropped)
+                    .arg(queueStats.superseded)
+                    .arg(queueStats.highWater)
+                    .arg(queueStats.capacity));
     emit logMessage(QStringLiteral("CAN解析线程已停止"));
 }
 
-float CanParserWorker::byt2Float(uint8_t high,
-                                uint8_t low,
-                                MotorField field) const
+void CanParserWorker::setBatchSize(int batchSize)
 {
-    int intValue = 0;
-
-    switch (field)
-    {
-    case MotorField::Pos:
-    {
-        intValue = (static_cast<int>(high) << 8) | low;
-        return uintToFloat(intValue, -12.5f, 12.5f, 16);
-    }
-
-    case MotorField::Vel:
-    {
-        intValue = (static_cast<int>(high) << 4) | (low >> 4);
-        return uintToFloat(intValue, -30.0f, 30.0f, 12);
-    }
-
-    case MotorField::Torque:
-    {
-        intValue = ((high & 0x0F) << 8) | low;
-        return uintToFloat(intValue, -10.0f, 10.0f, 12);
-    }
-    }
-
-    throw std::invalid_argument("Unknown MotorField");
-}
-
-//将整数转化成浮点数
-float CanParserWorker::uintToFloat(int x_int, float x_min, float x_max, int bits) const
-{
-    float span = x_max - x_min;
-    float offset = x_min;
-    return ((float)x_int) * span / ((float)((1 << bits) - 1)) + offset;
+    batchSize_.store(std::max(1, std::min(batchSize, kMaxBatch)));
 }
 
 void CanParserWorker::stop()
 {
     running_.store(false);
+    if (canRxQueue_) {
+        canRxQueue_->wakeConsumer();
+    }
 }
 
 
@@ -1,31 +1,26 @@
 #ifndef SERIAL_CAN_WORKERS_H
 #define SERIAL_CAN_WORKERS_H
 
-#include "FIFO.h"
 #include "SerialPort.h"
+#include "can_frame_codec.h"
+#include "can_frame_ring.h"
+#include "can_rx_queue.h"
+#include "monotonic_clock.h"
+#include "spsc_ring.h"
+#include "trace_log.h"
 
 #include <QObject>
-#include <QMutex>
-#include <QWaitCondition>
 #include <atomic>
 #include <array>
 #include <cstdint>
 
-
 class SerialRxWorker : public QObject
 {
     Q_OBJECT
 public:
-    SerialRxWorker(SerialPort *serial, FIFO *canRxFifo, FIFO *uartRxFifo,
-                   QMutex *canMutex, QMutex *uartMutex,
-                   QWaitCondition *canDataReady,
+    SerialRxWorker(SerialPort *serial, CanRxQueue *canRxQueue, SpscRing<uint8_t> *uartRxQueue,
                    QObject *parent = nullptr);
-    enum class ExtractResult
-    {
-        GotFrame,
-        NeedMoreData,
-        NoFrame
-    };
+    using ExtractResult = CanFrameCodec::ExtractResult;
 
 
 public slots:
@@ -36,15 +31,9 @@ signals:
     void logMessage(const QString &message);
 
 private:
-    SerialRxWorker::ExtractResult  tryExtractCanFrame(std::vector<uint8_t> &streamBuf,
-                            std::array<uint8_t, 16> &canFrame) const;
-
     SerialPort *serial_ = nullptr;
-    FIFO *canRxFifo_ = nullptr;
-    FIFO *uartRxFifo_ = nullptr;
-    QMutex *canMutex_ = nullptr;
-    QMutex *uartMutex_ = nullptr;
-    QWaitCondition *canDataReady_ = nullptr;
+    CanRxQueue *canRxQueue_ = nullptr;
+    SpscRing<uint8_t> *uartRxQueue_ = nullptr;
     std::atomic_bool running_{false};
 
 };
@@ -53,33 +42,27 @@ class CanParserWorker : public QObject
 {
     Q_OBJECT
 public:
-    CanParserWorker(FIFO *canRxFifo, QMutex *canMutex,
-                    QWaitCondition *canDataReady,
-                    QObject *parent = nullptr);
+    explicit CanParserWorker(CanRxQueue *canRxQueue, QObject *parent = nullptr);
+
+    static constexpr int kMaxBatch = 64;
+
+    /**
+     * @brief 每次从队列最多取出的记录数 (1-kMaxBatch)；1即逐帧解析、逐帧发布
+     */
+    void setBatchSize(int batchSize);
 
 public slots:
     void start();
     void stop();
 
 signals:
-    void jointStateUpdated(int jointIndex, float position, float velocity);
+    void jointStateUpdated(int jointIndex, float position, float velocity, qint64 rxTimeNs);
     void logMessage(const QString &message);
 
 private:
-    enum class MotorField
-    {
-        Pos,
-        Vel,
-        Torque
-    };
-
-    float byt2Float(uint8_t high,uint8_t low,MotorField field) const;
-
-    float uintToFloat(int x_int, float x_min, float x_max, int bits) const;
-    FIFO *canRxFifo_ = nullptr;
-    QMutex *canMutex_ = nullptr;
-    QWaitCondition *canDataReady_ = nullptr;
+    CanRxQueue *canRxQueue_ = nullptr;
     std::atomic_bool running_{false};
+    std::atomic_int batchSize_{kMaxBatch};
 };
 
 #endif // SERIAL_CAN_WORKERS_H
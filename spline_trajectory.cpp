@@ -0,0 +1,152 @@
+#include "spline_trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr size_t kMaxBuckets = 1u << 16;
+
+} // namespace
+
+bool SplineTrajectory::build(const std::vector<Vector3f>& points, const std::vector<float>& times, SplineKind kind)
+{
+    segments_.clear();
+    bucketFirstSegment_.clear();
+
+    const size_t n = points.size();
+    if (n < 2 || times.size() != n) {
+        return false;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        if (!(times[i] > times[i - 1])) {
+            return false;
+        }
+    }
+
+    // 1. 三次样条节点速度：C2连续条件构成三对角方程组，端点速度为0 (Thomas算法)
+    std::vector<Vector3f> v(n, Vector3f::Zero());
+    if (n > 2) {
+        const size_t m = n - 2;  // 内部节点数
+        std::vector<float> lower(m), diag(m), upper(m);
+        std::vector<Vector3f> rhs(m);
+        for (size_t k = 0; k < m; ++k) {
+            const size_t i = k + 1;
+            const float h0 = times[i] - times[i - 1];
+            const float h1 = times[i + 1] - times[i];
+            lower[k] = h1;
+            diag[k] = 2.0f * (h0 + h1);
+            upper[k] = h0;
+            rhs[k] = 3.0f * (h1 * (points[i] - points[i - 1]) / h0 + h0 * (points[i + 1] - points[i]) / h1);
+        }
+        for (size_t k = 1; k < m; ++k) {
+            const float w = lower[k] / diag[k - 1];
+            diag[k] -= w * upper[k - 1];
+            rhs[k] -= w * rhs[k - 1];
+        }
+        v[m] = rhs[m - 1] / diag[m - 1];
+        for (size_t k = m - 1; k-- > 0;) {
+            v[k + 1] = (rhs[k] - upper[k] * v[k + 2]) / diag[k];
+        }
+    }
+
+    // 2. 节点加速度 (三次样条在内部节点处C2连续)
+    std::vector<Vector3f> a(n, Vector3f::Zero());
+    if (kind == SplineKind::Quintic) {
+        for (size_t i = 1; i + 1 < n; ++i) {
+            const float h = times[i + 1] - times[i];
+            a[i] = 6.0f * (points[i + 1] - points[i]) / (h * h) - (4.0f * v[i] + 2.0f * v[i + 1]) / h;
+        }
+        // 端点加速度保持为0，起停更平顺
+    }
+
+    // 3. 各段多项式系数
+    segments_.resize(n - 1);
+    float minSpan = times[n - 1] - times[0];
+    for (size_t i = 0; i + 1 < n; ++i) {
+        Segment& seg = segments_[i];
+        seg.t0 = times[i];
+        seg.c.fill(0.0f);
+
+        const float h = times[i + 1] - times[i];
+        minSpan = std::min(minSpan, h);
+        const float h2 = h * h;
+        const float h3 = h2 * h;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const float p0 = points[i][axis], p1 = points[i + 1][axis];
+            const float v0 = v[i][axis], v1 = v[i + 1][axis];
+            float* c = &seg.c[axis * kOrder];
+            c[0] = p0;
+            c[1] = v0;
+            if (kind == SplineKind::Cubic) {
+                c[2] = (3.0f * (p1 - p0) / h - 2.0f * v0 - v1) / h;
+                c[3] = (2.0f * (p0 - p1) / h + v0 + v1) / h2;
+            } else {
+                const float a0 = a[i][axis], a1 = a[i + 1][axis];
+                c[2] = 0.5f * a0;
+                c[3] = (20.0f * (p1 - p0) - (8.0f * v1 + 12.0f * v0) * h - (3.0f * a0 - a1) * h2) / (2.0f * h3);
+                c[4] = (30.0f * (p0 - p1) + (14.0f * v1 + 16.0f * v0) * h + (3.0f * a0 - 2.0f * a1) * h2) / (2.0f * h3 * h);
+                c[5] = (12.0f * (p1 - p0) - 6.0f * (v1 + v0) * h - (a0 - a1) * h2) / (2.0f * h3 * h2);
+            }
+        }
+    }
+
+    startTime_ = times.front();
+    endTime_ = times.back();
+
+    // 4. 均匀时间桶：桶宽不大于最短段，每个桶最多跨越两段
+    const float span = endTime_ - startTime_;
+    const size_t buckets = std::min(kMaxBuckets, static_cast<size_t>(std::ceil(span / minSpan)) + 1);
+    bucketInvWidth_ = static_cast<float>(buckets) / span;
+    bucketFirstSegment_.resize(buckets + 1);
+    size_t seg = 0;
+    for (size_t b = 0; b <= buckets; ++b) {
+        const float tb = startTime_ + static_cast<float>(b) / bucketInvWidth_;
+        while (seg + 1 < segments_.size() && segments_[seg + 1].t0 <= tb) {
+            ++seg;
+        }
+        bucketFirstSegment_[b] = static_cast<uint32_t>(seg);
+    }
+
+    return true;
+}
+
+size_t SplineTrajectory::segmentIndex(float t) const
+{
+    const size_t b = std::min(static_cast<size_t>((t - startTime_) * bucketInvWidth_),
+                              bucketFirstSegment_.size() - 1);
+    size_t seg = bucketFirstSegment_[b];
+    // 桶宽达到上限时才可能需要多走几步
+    while (seg + 1 < segments_.size() && segments_[seg + 1].t0 <= t) {
+        ++seg;
+    }
+    return seg;
+}
+
+TrajectoryPoint SplineTrajectory::evaluate(float t) const
+{
+    TrajectoryPoint point;
+    if (segments_.empty()) {
+        return point;
+    }
+
+    t = std::clamp(t, startTime_, endTime_);
+    const Segment& seg = segments_[segmentIndex(t)];
+    const float tau = t - seg.t0;
+
+    // Horner求值：位置、速度、加速度
+    for (int axis = 0; axis < 3; ++axis) {
+        const float* c = &seg.c[axis * kOrder];
+        point.position[axis] = c[0] + tau * (c[1] + tau * (c[2] + tau * (c[3] + tau * (c[4] + tau * c[5]))));
+        point.velocity[axis] = c[1] + tau * (2.0f * c[2] + tau * (3.0f * c[3] + tau * (4.0f * c[4] + tau * 5.0f * c[5])));
+        point.acceleration[axis] = 2.0f * c[2] + tau * (6.0f * c[3] + tau * (12.0f * c[4] + tau * 20.0f * c[5]));
+    }
+
+    // 终点之后保持静止
+    if (t >= endTime_ && endTime_ > startTime_) {
+        point.velocity.setZero();
+        point.acceleration.setZero();
+    }
+    return point;
+}
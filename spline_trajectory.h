@@ -0,0 +1,57 @@
+#ifndef SPLINE_TRAJECTORY_H
+#define SPLINE_TRAJECTORY_H
+
+#include "robot_common.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 经过路径点的三维样条 (笛卡尔或关节空间均可)
+ *
+ * 各段多项式系数预计算在连续数组中；时间到段号通过均匀时间桶O(1)映射，
+ * 求值只需几次乘加，与路径点数量无关。
+ */
+class SplineTrajectory
+{
+public:
+    static constexpr int kOrder = 6;  // 每轴系数个数 (五次多项式，三次时高次项为0)
+
+    SplineTrajectory() = default;
+
+    /**
+     * @brief 构建样条
+     * @param points 路径点 (至少2个)
+     * @param times 到达各路径点的时刻，严格递增，大小与points一致
+     * @param kind 样条类型
+     * @return 输入是否有效
+     */
+    bool build(const std::vector<Vector3f>& points, const std::vector<float>& times, SplineKind kind);
+
+    /**
+     * @brief 求t时刻的位置、速度、加速度 (超出范围时钳位到端点)
+     */
+    TrajectoryPoint evaluate(float t) const;
+
+    bool empty() const { return segments_.empty(); }
+    size_t segmentCount() const { return segments_.size(); }
+    float startTime() const { return startTime_; }
+    float endTime() const { return endTime_; }
+
+private:
+    struct Segment
+    {
+        float t0;                                // 段起始时刻
+        std::array<float, 3 * kOrder> c;         // c[axis*kOrder + k]，τ^k 的系数
+    };
+
+    size_t segmentIndex(float t) const;
+
+    std::vector<Segment> segments_;
+    std::vector<uint32_t> bucketFirstSegment_;  // 每个时间桶起点所在段
+    float bucketInvWidth_ = 0.0f;
+    float startTime_ = 0.0f;
+    float endTime_ = 0.0f;
+};
+
+#endif // SPLINE_TRAJECTORY_H
@@ -0,0 +1,231 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "futex_wait.h"
+#include "monotonic_clock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief 单生产者单消费者无锁环形队列
+ *
+ * 容量向上取整为2的幂，下标用32位计数器自由回绕、按掩码取位置。
+ * 写下标和读下标各占一个缓存行，并各自缓存对方下标的旧值，
+ * 只在旧值显示已满/已空时才重新读取对方的缓存行，常态下生产者和消费者互不争用。
+ * 支持批量写入/取出 (一次原子发布)；消费者可在队列为空时用futex休眠，
+ * 生产者只在确有等待者时才做唤醒系统调用。可选的覆盖模式下，队列满时生产者丢弃最旧的元素。
+ * 只适用于可平凡拷贝的元素类型。
+ */
+template <typename T>
+class SpscRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing需要可平凡拷贝的类型");
+
+public:
+    /**
+     * @param capacity 元素个数，向上取整为2的幂 (至少为2，最多2^31)
+     * @param wakeups 是否支持waitForData；不需要阻塞等待的消费者 (轮询) 可关闭，生产者省去等待者检查
+     * @param overwrite 是否允许pushOverwrite；开启后读下标由生产者和消费者共同推进 (CAS)，取出略慢
+     */
+    explicit SpscRing(size_t capacity, bool wakeups = true, bool overwrite = false)
+        : wakeups_(wakeups)
+        , overwrite_(overwrite)
+    {
+        size_t rounded = 2;
+        while (rounded < capacity && rounded < (size_t(1) << 31)) {
+            rounded <<= 1;
+        }
+        mask_ = static_cast<uint32_t>(rounded - 1);
+        buffer_.reset(new T[rounded]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return static_cast<size_t>(mask_) + 1; }
+
+    /**
+     * @brief 当前元素个数 (其他线程调用时只是近似值)
+     */
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 写入一个元素 (仅生产者线程)，队列满时返回false
+     */
+    bool push(const T& item) { return pushBatch(&item, 1) == 1; }
+
+    /**
+     * @brief 写入最多count个元素 (仅生产者线程)，一次发布
+     * @return 实际写入的个数 (队列剩余空间不足时小于count)
+     */
+    size_t pushBatch(const T* items, size_t count)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t free = capacity32() - (tail - headCache_);
+        if (free < count) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            free = capacity32() - (tail - headCache_);
+        }
+        const uint32_t n = static_cast<uint32_t>(std::min<size_t>(count, free));
+        if (n == 0) {
+            return 0;
+        }
+        copyIn(tail, items, n);
+        publish(tail + n);
+        return n;
+    }
+
+    /**
+     * @brief 写入一个元素，队列满时先丢弃最旧的一个 (仅生产者线程，需开启overwrite)
+     * @return 是否丢弃了最旧的元素
+     */
+    bool pushOverwrite(const T& item)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        bool dropped = false;
+        if (tail - head == capacity32()) {
+            // CAS失败说明消费者刚取走了数据，已有空位
+            dropped = head_.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel);
+        }
+        copyIn(tail, &item, 1);
+        publish(tail + 1);
+        return dropped;
+    }
+
+    /**
+     * @brief 取出一个元素 (仅消费者线程)，队列空时返回false
+     */
+    bool pop(T& item) { return popBatch(&item, 1) == 1; }
+
+    /**
+     * @brief 取出最多maxCount个元素 (仅消费者线程)
+     * @return 实际取出的个数
+     */
+    size_t popBatch(T* out, size_t maxCount)
+    {
+        if (overwrite_) {
+            return popBatchShared(out, maxCount);
+        }
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t available = tailCache_ - head;
+        if (available < maxCount) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            available = tailCache_ - head;
+        }
+        const uint32_t n = static_cast<uint32_t>(std::min<size_t>(maxCount, available));
+        if (n == 0) {
+            return 0;
+        }
+        copyOut(head, out, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief 队列为空时休眠，直到有数据、wakeConsumer()或超时 (仅消费者线程，需开启wakeups)
+     * @param timeoutNs 最长等待时间，按真实单调时间计
+     * @return 返回时队列是否非空
+     */
+    bool waitForData(int64_t timeoutNs)
+    {
+        if (tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        // waiters++ / tail读取 与生产者的 tail写入 / waiters读取 构成Dekker式配对 (均为seq_cst)，不会丢失唤醒
+        const uint32_t seen = generation_.load();
+        waiters_.fetch_add(1);
+        if (tail_.load() == head_.load(std::memory_order_relaxed)) {
+            futexWaitUntil(&generation_, seen, MonotonicClock().nowNs() + timeoutNs);
+        }
+        waiters_.fetch_sub(1);
+        return tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 让阻塞在waitForData中的消费者返回 (任意线程，停止消费者时调用)
+     */
+    void wakeConsumer()
+    {
+        generation_.fetch_add(1);
+        futexWakeAll(&generation_);
+    }
+
+private:
+    uint32_t capacity32() const { return mask_ + 1; }
+
+    // overwrite模式：生产者可能同时把读下标推过最旧的元素并覆盖其位置，
+    // 先拷出再CAS推进读下标，CAS失败说明拷出的数据可能已被覆盖，重新读取 (与SeqLockSlot的校验同理)
+    size_t popBatchShared(T* out, size_t maxCount)
+    {
+        while (true) {
+            uint32_t head = head_.load(std::memory_order_acquire);
+            const uint32_t tail = tail_.load(std::memory_order_acquire);
+            const uint32_t n = static_cast<uint32_t>(std::min<size_t>(maxCount, tail - head));
+            if (n == 0) {
+                return 0;
+            }
+            copyOut(head, out, n);
+            if (head_.compare_exchange_strong(head, head + n, std::memory_order_acq_rel)) {
+                return n;
+            }
+        }
+    }
+
+    void copyIn(uint32_t position, const T* items, uint32_t n)
+    {
+        const uint32_t index = position & mask_;
+        const uint32_t first = std::min(n, capacity32() - index);
+        std::memcpy(&buffer_[index], items, first * sizeof(T));
+        std::memcpy(&buffer_[0], items + first, (n - first) * sizeof(T));
+    }
+
+    void copyOut(uint32_t position, T* out, uint32_t n) const
+    {
+        const uint32_t index = position & mask_;
+        const uint32_t first = std::min(n, capacity32() - index);
+        std::memcpy(out, &buffer_[index], first * sizeof(T));
+        std::memcpy(out + first, &buffer_[0], (n - first) * sizeof(T));
+    }
+
+    void publish(uint32_t tail)
+    {
+        if (!wakeups_) {
+            tail_.store(tail, std::memory_order_release);
+            return;
+        }
+        tail_.store(tail);
+        if (waiters_.load() > 0) {
+            generation_.fetch_add(1);
+            futexWakeAll(&generation_);
+        }
+    }
+
+    // 生产者写、消费者读
+    alignas(64) std::atomic<uint32_t> tail_{0};
+    uint32_t headCache_ = 0;                     // 生产者看到的读下标旧值
+    // 消费者写、生产者读
+    alignas(64) std::atomic<uint32_t> head_{0};
+    uint32_t tailCache_ = 0;                     // 消费者看到的写下标旧值
+    // 休眠的消费者
+    alignas(64) std::atomic<uint32_t> generation_{0};   // futex字：唤醒时加1
+    std::atomic<uint32_t> waiters_{0};
+    // 只读的配置
+    alignas(64) uint32_t mask_ = 0;
+    bool wakeups_;
+    bool overwrite_;
+    std::unique_ptr<T[]> buffer_;
+};
+
+#endif // SPSC_RING_H
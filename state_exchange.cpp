@@ -0,0 +1,199 @@
+#include "state_exchange.h"
+#include "futex_wait.h"
+#include "monotonic_clock.h"
+
+#include <algorithm>
+
+namespace {
+
+// 等待futex字离开seen，或到达deadlineNs；虚拟时钟下没有真实的等待，直接推进到超时时刻
+// waiters++ / generation读取 与发布方的 generation++ / waiters读取 构成Dekker式配对 (均为seq_cst)，不会丢失唤醒
+void waitForChange(const std::atomic<uint32_t>& generation, std::atomic<uint32_t>& waiters,
+                   uint32_t seen, int64_t deadlineNs)
+{
+    Clock& clock = Clock::instance();
+    if (clock.isVirtual()) {
+        clock.sleepUntil(deadlineNs);
+        return;
+    }
+    waiters.fetch_add(1);
+    if (generation.load() == seen) {
+        futexWaitUntil(&generation, seen, deadlineNs);
+    }
+    waiters.fetch_sub(1);
+}
+
+// 推进futex字，只在有等待者时才做唤醒系统调用
+void signalChange(std::atomic<uint32_t>& generation, const std::atomic<uint32_t>& waiters)
+{
+    generation.fetch_add(1);
+    if (waiters.load() > 0) {
+        futexWakeAll(&generation);
+    }
+}
+
+} // namespace
+
+void JointStateExchange::publish(const JointState& state)
+{
+    if (state.jointIndex < 1 || state.jointIndex > kJointCount) {
+        return;
+    }
+    slots_[state.jointIndex - 1].value.store(state);
+    signalChange(generation_, waiters_);
+}
+
+JointStateExchange::Versions JointStateExchange::versions() const
+{
+    Versions v;
+    for (int j = 0; j < kJointCount; ++j) {
+        v[j] = slots_[j].value.version();
+    }
+    return v;
+}
+
+bool JointStateExchange::waitForFreshSet(Versions& consumed, int64_t deadlineNs) const
+{
+    Clock& clock = Clock::instance();
+    while (true) {
+        const uint32_t seen = generation_.load();
+        const Versions current = versions();
+        bool fresh = true;
+        for (int j = 0; j < kJointCount; ++j) {
+            fresh = fresh && current[j] > consumed[j];
+        }
+        if (fresh) {
+            consumed = current;
+            return true;
+        }
+        if (clock.nowNs() >= deadlineNs) {
+            return false;
+        }
+        waitForChange(generation_, waiters_, seen, deadlineNs);
+    }
+}
+
+FeedbackAssembler::FeedbackAssembler(uint32_t expectedMask)
+    : expectedMask_(expectedMask)
+{
+}
+
+uint64_t FeedbackAssembler::beginRound(int64_t sentNs)
+{
+    RoundInfo info = round_.load();
+    ++info.round;
+    info.sentNs = sentNs;
+    round_.store(info);
+    return info.round;
+}
+
+void FeedbackAssembler::publish(const JointState& state)
+{
+    if (state.jointIndex < 1 || state.jointIndex > FeedbackSnapshot::kJointCount) {
+        return;
+    }
+
+    // 按接收时刻归入轮次：本轮下发之前收到的帧是对上一轮指令的回报
+    const RoundInfo info = round_.load();
+    uint64_t round = info.round;
+    if (round > 0 && state.timestampNs < info.sentNs) {
+        --round;
+    }
+    if (round == 0) {
+        return;  // 尚未下发过指令
+    }
+    if (round < pending_.round || (round == pending_.round && pending_.complete())) {
+        lateFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (round > pending_.round) {
+        pending_ = FeedbackSnapshot();
+        pending_.round = round;
+        pending_.expectedMask = expectedMask_.load(std::memory_order_relaxed);
+    }
+
+    const int index = state.jointIndex - 1;
+    pending_.joints[index] = state;
+    pending_.reportedMask |= 1u << index;
+    pending_.assembledNs = Clock::now();
+    int64_t earliest = pending_.assembledNs;
+    int64_t latest = 0;
+    for (int j = 0; j < FeedbackSnapshot::kJointCount; ++j) {
+        if (pending_.reportedMask & (1u << j)) {
+            const int64_t rxTimeNs = pending_.joints[j].timestampNs;
+            pending_.ageNs[j] = pending_.assembledNs - rxTimeNs;
+            earliest = std::min(earliest, rxTimeNs);
+            latest = std::max(latest, rxTimeNs);
+        }
+    }
+    current_.store(pending_);
+
+    if (pending_.complete()) {
+        if (latest - earliest > maxSkewNs_.load(std::memory_order_relaxed)) {
+            maxSkewNs_.store(latest - earliest, std::memory_order_relaxed);
+        }
+        signalChange(generation_, waiters_);
+    }
+}
+
+bool FeedbackAssembler::waitForRound(uint64_t round, int64_t deadlineNs, FeedbackSnapshot& out)
+{
+    Clock& clock = Clock::instance();
+    bool complete = false;
+    while (true) {
+        const uint32_t seen = generation_.load();
+        out = current_.load();
+        if (out.round == round && out.complete()) {
+            complete = true;
+            break;
+        }
+        if (clock.nowNs() >= deadlineNs) {
+            break;
+        }
+        waitForChange(generation_, waiters_, seen, deadlineNs);
+    }
+
+    if (out.round != round) {
+        // 本轮一帧都没收到
+        out = FeedbackSnapshot();
+        out.round = round;
+        out.expectedMask = expectedMask_.load(std::memory_order_relaxed);
+        out.assembledNs = clock.nowNs();
+    }
+
+    rounds_.fetch_add(1, std::memory_order_relaxed);
+    if (complete) {
+        completeRounds_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        for (int j = 0; j < FeedbackSnapshot::kJointCount; ++j) {
+            if ((out.expectedMask & (1u << j)) && !out.reported(j + 1)) {
+                missing_[j].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return complete;
+}
+
+FeedbackSyncStats FeedbackAssembler::stats() const
+{
+    FeedbackSyncStats stats;
+    stats.rounds = rounds_.load(std::memory_order_relaxed);
+    stats.completeRounds = completeRounds_.load(std::memory_order_relaxed);
+    stats.lateFrames = lateFrames_.load(std::memory_order_relaxed);
+    for (int j = 0; j < FeedbackSnapshot::kJointCount; ++j) {
+        stats.missing[j] = missing_[j].load(std::memory_order_relaxed);
+    }
+    stats.maxSkewNs = maxSkewNs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void FeedbackAssembler::resetStats()
+{
+    rounds_.store(0, std::memory_order_relaxed);
+    completeRounds_.store(0, std::memory_order_relaxed);
+    lateFrames_.store(0, std::memory_order_relaxed);
+    for (auto& missing : missing_) {
+        missing.store(0, std::memory_order_relaxed);
+    }
+    maxSkewNs_.store(0, std::memory_order_relaxed);
+}
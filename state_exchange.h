@@ -0,0 +1,276 @@
+#ifndef STATE_EXCHANGE_H
+#define STATE_EXCHANGE_H
+
+#include "robot_common.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 单写多读的顺序锁槽 (seqlock)
+ *
+ * 写者：序号变奇数 -> 写数据 -> 序号变偶数；读者读前后两次序号一致且为偶数即为完整快照。
+ * 数据按64位字以relaxed原子读写，读者从不阻塞写者，写者也不等待读者。
+ * 只适用于可平凡拷贝的小结构体。
+ */
+template <typename T>
+class SeqLockSlot
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLockSlot需要可平凡拷贝的类型");
+
+public:
+    SeqLockSlot() { store(T()); sequence_.store(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief 写入新值 (仅允许单个写者线程)
+     */
+    void store(const T& value)
+    {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取一次，遇到并发写入时返回false
+     */
+    bool tryLoad(T& out) const
+    {
+        const uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief 读取完整快照 (与写入冲突时重试，写者一次写入只需几十纳秒)
+     */
+    T load() const
+    {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief 已完成的写入次数
+     */
+    uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, kWords> data_;
+};
+
+/**
+ * @brief 关节状态交换区：CAN解析线程写，控制线程 (及界面) 读，无锁、无事件循环
+ *
+ * 每个关节一个独立缓存行的槽，不同关节的写入互不干扰。
+ * 另有一个全局发布计数 (futex字)，控制线程可阻塞等待"全部关节都有新状态"，
+ * 发布方只在有等待者时才做唤醒系统调用。
+ */
+class JointStateExchange
+{
+public:
+    static constexpr int kJointCount = 3;
+
+    /**
+     * @brief 发布关节状态 (state.jointIndex为1-3，其余忽略)；每个关节只能有一个写者线程
+     */
+    void publish(const JointState& state);
+
+    /**
+     * @brief 读取关节最新状态
+     * @param jointIndex 关节号 1-3
+     * @return 该关节是否已收到过状态
+     */
+    bool read(int jointIndex, JointState& state) const
+    {
+        if (jointIndex < 1 || jointIndex > kJointCount) {
+            return false;
+        }
+        const Slot& slot = slots_[jointIndex - 1];
+        state = slot.value.load();
+        return state.jointIndex == jointIndex;
+    }
+
+    /**
+     * @brief 关节状态累计更新次数
+     */
+    uint64_t updates(int jointIndex) const
+    {
+        return jointIndex >= 1 && jointIndex <= kJointCount ? slots_[jointIndex - 1].value.version() : 0;
+    }
+
+    using Versions = std::array<uint64_t, kJointCount>;
+
+    /**
+     * @brief 阻塞到所有关节都比consumed更新，或到达绝对时刻deadlineNs
+     * @param consumed 上次使用的各关节版本，成功时更新为当前版本
+     * @param deadlineNs 超时时刻 (Clock::now()时基)
+     * @return true 凑齐一组新状态；false 超时
+     */
+    bool waitForFreshSet(Versions& consumed, int64_t deadlineNs) const;
+
+    /**
+     * @brief 当前各关节版本
+     */
+    Versions versions() const;
+
+private:
+    struct alignas(64) Slot
+    {
+        SeqLockSlot<JointState> value;
+    };
+
+    std::array<Slot, kJointCount> slots_;
+    alignas(64) std::atomic<uint32_t> generation_{0};   // futex字：每次发布加1
+    mutable std::atomic<uint32_t> waiters_{0};
+};
+
+/**
+ * @brief 一个指令轮次的各关节反馈快照
+ */
+struct FeedbackSnapshot
+{
+    static constexpr int kJointCount = JointStateExchange::kJointCount;
+
+    uint64_t round = 0;          // 指令轮次 (FeedbackAssembler::beginRound的返回值)
+    uint32_t expectedMask = 0;   // 应回报的关节，bit0对应关节1
+    uint32_t reportedMask = 0;   // 本轮已回报的关节
+    int64_t assembledNs = 0;     // 凑齐 (或等待超时) 的时刻
+    std::array<JointState, kJointCount> joints;    // 下标0-2对应关节1-3，仅reportedMask中的有效
+    std::array<int64_t, kJointCount> ageNs{};      // assembledNs - 该关节接收时刻
+
+    bool complete() const { return expectedMask != 0 && (reportedMask & expectedMask) == expectedMask; }
+    bool reported(int jointIndex) const { return (reportedMask >> (jointIndex - 1)) & 1u; }
+};
+
+/**
+ * @brief 反馈同步统计
+ */
+struct FeedbackSyncStats
+{
+    uint64_t rounds = 0;            // 等待过的轮次
+    uint64_t completeRounds = 0;    // 超时前凑齐的轮次
+    uint64_t lateFrames = 0;        // 轮次已过才到达的反馈帧
+    std::array<uint64_t, FeedbackSnapshot::kJointCount> missing{};  // 各关节超时未回报次数
+    int64_t maxSkewNs = 0;          // 完整快照内各关节接收时刻的最大差
+};
+
+/**
+ * @brief 按指令轮次组装各关节反馈，得到同一轮的一致快照
+ *
+ * 控制线程每次下发指令时调用beginRound()开启新轮次；CAN解析线程publish()的
+ * 每帧按接收时刻归入轮次 (早于本轮下发时刻的帧仍属上一轮)，
+ * 本轮所有应回报关节到齐即唤醒等待方。控制线程用waitForRound()等待，
+ * 超时则得到只含已回报关节的部分快照，并按关节累计缺失次数。
+ * 轮次信息和快照都放在seqlock槽中，两侧都不加锁。
+ */
+class FeedbackAssembler
+{
+public:
+    explicit FeedbackAssembler(uint32_t expectedMask = 0x7);
+
+    /**
+     * @brief 设置应回报的关节 (bit0对应关节1)
+     */
+    void setExpectedJoints(uint32_t mask) { expectedMask_.store(mask, std::memory_order_relaxed); }
+
+    /**
+     * @brief 开启新轮次 (仅控制线程调用)
+     * @param sentNs 本轮指令的下发时刻
+     * @return 新轮次号 (从1开始)
+     */
+    uint64_t beginRound(int64_t sentNs);
+
+    /**
+     * @brief 当前轮次号，尚未下发过指令时为0
+     */
+    uint64_t currentRound() const { return round_.load().round; }
+
+    /**
+     * @brief 归入一帧反馈 (仅允许单个写者线程，通常为CAN解析线程)
+     */
+    void publish(const JointState& state);
+
+    /**
+     * @brief 等待round轮所有应回报关节到齐，或到达绝对时刻deadlineNs (仅控制线程调用)
+     * @param out 本轮快照；超时时只含已回报的关节
+     * @return 是否凑齐
+     */
+    bool waitForRound(uint64_t round, int64_t deadlineNs, FeedbackSnapshot& out);
+
+    /**
+     * @brief 同步统计快照 (线程安全)
+     */
+    FeedbackSyncStats stats() const;
+    void resetStats();
+
+private:
+    struct RoundInfo
+    {
+        uint64_t round = 0;
+        int64_t sentNs = 0;
+    };
+
+    SeqLockSlot<RoundInfo> round_;          // 控制线程写
+    SeqLockSlot<FeedbackSnapshot> current_; // 解析线程写：最近一轮的组装进度
+    FeedbackSnapshot pending_;              // 解析线程独占
+    std::atomic<uint32_t> expectedMask_;
+
+    alignas(64) std::atomic<uint32_t> generation_{0};   // futex字：每凑齐一轮加1
+    std::atomic<uint32_t> waiters_{0};
+
+    std::atomic<uint64_t> rounds_{0};
+    std::atomic<uint64_t> completeRounds_{0};
+    std::atomic<uint64_t> lateFrames_{0};
+    std::array<std::atomic<uint64_t>, FeedbackSnapshot::kJointCount> missing_{};
+    std::atomic<int64_t> maxSkewNs_{0};
+};
+
+/**
+ * @brief 状态使用时的年龄统计 (使用时刻 - 串口接收时刻)
+ */
+struct StateAgeStats
+{
+    uint64_t samples = 0;
+    uint64_t missing = 0;   // 读取时该关节尚无状态的次数
+    int64_t sumAgeNs = 0;
+    int64_t maxAgeNs = 0;
+
+    void add(int64_t ageNs)
+    {
+        ++samples;
+        sumAgeNs += ageNs;
+        if (ageNs > maxAgeNs) {
+            maxAgeNs = ageNs;
+        }
+    }
+
+    double meanAgeUs() const { return samples > 0 ? sumAgeNs * 1e-3 / samples : 0.0; }
+};
+
+#endif // STATE_EXCHANGE_H
@@ -0,0 +1,299 @@
+#include "time_optimal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double kMaxPathVelocitySq = 1e8;  // 无速度约束时 ṡ² 的上界，保证可行域有界
+constexpr double kTolerance = 1e-9;
+
+// 半平面 ax·x + au·u <= b
+struct HalfPlane
+{
+    double ax;
+    double au;
+    double b;
+};
+
+// 网格点处的约束系数：τ = a·u + b·x + c，以及速度约束 x <= xMax
+struct GridConstraint
+{
+    Eigen::Vector3d a;
+    Eigen::Vector3d b;
+    Eigen::Vector3d c;
+    double xMax;
+};
+
+void setError(std::string* error, const std::string& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+/**
+ * @brief 二维线性规划：在半平面交集上求x的最大/最小值
+ *
+ * 约束只有十来个，直接枚举两两交点即可，比通用单纯形更简单也更稳。
+ */
+bool extremeX(const std::vector<HalfPlane>& planes, bool maximize, double& xOut)
+{
+    bool found = false;
+    double best = 0.0;
+    for (size_t i = 0; i < planes.size(); ++i) {
+        for (size_t j = i + 1; j < planes.size(); ++j) {
+            const HalfPlane& p = planes[i];
+            const HalfPlane& q = planes[j];
+            const double det = p.ax * q.au - p.au * q.ax;
+            if (std::abs(det) < 1e-14) {
+                continue;
+            }
+            const double x = (p.b * q.au - p.au * q.b) / det;
+            const double u = (p.ax * q.b - p.b * q.ax) / det;
+
+            bool feasible = true;
+            for (const HalfPlane& h : planes) {
+                if (h.ax * x + h.au * u > h.b + kTolerance * (1.0 + std::abs(h.b))) {
+                    feasible = false;
+                    break;
+                }
+            }
+            if (feasible && (!found || (maximize ? x > best : x < best))) {
+                best = x;
+                found = true;
+            }
+        }
+    }
+    xOut = best;
+    return found;
+}
+
+// 固定x时由力矩约束 |a·u + rest| <= τmax 得到的u范围，收窄[uMin, uMax]
+bool narrowAcceleration(const Eigen::Vector3d& a, const Eigen::Vector3d& rest, const Eigen::Vector3d& tauMax,
+                        double& uMin, double& uMax)
+{
+    for (int j = 0; j < 3; ++j) {
+        if (std::abs(a[j]) < 1e-12) {
+            if (std::abs(rest[j]) > tauMax[j] * (1.0 + 1e-6)) {
+                return false;
+            }
+            continue;
+        }
+        double lo = (-tauMax[j] - rest[j]) / a[j];
+        double hi = (tauMax[j] - rest[j]) / a[j];
+        if (lo > hi) {
+            std::swap(lo, hi);
+        }
+        uMin = std::max(uMin, lo);
+        uMax = std::min(uMax, hi);
+    }
+    return uMin <= uMax + kTolerance;
+}
+
+} // namespace
+
+std::array<damiao::Limit_param, 3> TimeOptimalParameterizer::motorLimits(damiao::DM_Motor_Type joint1,
+                                                                         damiao::DM_Motor_Type joint2,
+                                                                         damiao::DM_Motor_Type joint3)
+{
+    return {damiao::limit_param[joint1], damiao::limit_param[joint2], damiao::limit_param[joint3]};
+}
+
+bool TimeOptimalParameterizer::parameterize(const JointPath& path, const RobotModel& model,
+                                            TrajectoryStore& table, Result* result,
+                                            std::string* error) const
+{
+    const int n = options_.gridSize;
+    if (n < 2 || !(options_.outputDt > 0.0f) || !(options_.limitScale > 0.0f)) {
+        setError(error, "TOPP参数无效");
+        return false;
+    }
+    const double delta = 1.0 / n;
+
+    Eigen::Vector3d dqMax, tauMax;
+    for (int j = 0; j < 3; ++j) {
+        dqMax[j] = options_.limits[j].DQ_MAX * options_.limitScale;
+        tauMax[j] = options_.limits[j].TAU_MAX * options_.limitScale;
+    }
+
+    // 1. 路径采样，关节1展开atan2跳变，保证q(s)连续
+    std::vector<Vector3f> q(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        if (!path(static_cast<float>(i * delta), q[i])) {
+            setError(error, "路径在s=" + std::to_string(i * delta) + "处逆解失败");
+            return false;
+        }
+        if (i > 0) {
+            for (int j = 0; j < 3; ++j) {
+                const float jump = q[i][j] - q[i - 1][j];
+                q[i][j] -= static_cast<float>(2.0 * M_PI * std::round(jump / (2.0 * M_PI)));
+            }
+        }
+        for (int j = 0; j < 3; ++j) {
+            if (std::abs(q[i][j]) > options_.limits[j].Q_MAX) {
+                setError(error, "关节" + std::to_string(j + 1) + "超出位置限幅");
+                return false;
+            }
+        }
+    }
+
+    // 2. 路径导数 q'(s), q''(s)：中心差分，二阶导对一阶导再差分以抑制float噪声
+    std::vector<Vector3f> dq(n + 1), ddq(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        const int lo = std::max(i - 1, 0), hi = std::min(i + 1, n);
+        dq[i] = (q[hi] - q[lo]) / static_cast<float>((hi - lo) * delta);
+    }
+    for (int i = 0; i <= n; ++i) {
+        const int lo = std::max(i - 1, 0), hi = std::min(i + 1, n);
+        ddq[i] = (dq[hi] - dq[lo]) / static_cast<float>((hi - lo) * delta);
+    }
+
+    // 3. 各网格点的力矩系数与速度上界
+    auto torque = [&model](const Vector3f& qi, const Vector3f& qd, const Vector3f& qdd) {
+        const std::vector<float> state = {qi[0], qi[1], qi[2], qd[0], qd[1], qd[2], qdd[0], qdd[1], qdd[2]};
+        return model.computeTorqueDecoupled(state).cast<double>();
+    };
+
+    std::vector<GridConstraint> grid(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        GridConstraint& g = grid[i];
+        g.c = torque(q[i], Vector3f::Zero(), Vector3f::Zero());
+        g.a = torque(q[i], Vector3f::Zero(), dq[i]) - g.c;
+        g.b = torque(q[i], dq[i], ddq[i]) - g.c;
+
+        g.xMax = kMaxPathVelocitySq;
+        for (int j = 0; j < 3; ++j) {
+            const double slope = std::abs(dq[i][j]);
+            if (slope > 1e-9) {
+                g.xMax = std::min(g.xMax, (dqMax[j] / slope) * (dqMax[j] / slope));
+            }
+        }
+    }
+
+    // 第i段 (匀加速u) 的约束：两端点处力矩均不超限，段内力矩近似线性变化
+    auto segmentPlanes = [&](int i, std::vector<HalfPlane>& planes) {
+        const GridConstraint& g0 = grid[i];
+        const GridConstraint& g1 = grid[i + 1];
+        planes.clear();
+        planes.push_back({-1.0, 0.0, 0.0});     // x >= 0
+        planes.push_back({1.0, 0.0, g0.xMax});  // 速度约束
+        for (int j = 0; j < 3; ++j) {
+            planes.push_back({g0.b[j], g0.a[j], tauMax[j] - g0.c[j]});
+            planes.push_back({-g0.b[j], -g0.a[j], tauMax[j] + g0.c[j]});
+            // 段末: x_{i+1} = x + 2Δu
+            const double au = g1.a[j] + 2.0 * delta * g1.b[j];
+            planes.push_back({g1.b[j], au, tauMax[j] - g1.c[j]});
+            planes.push_back({-g1.b[j], -au, tauMax[j] + g1.c[j]});
+        }
+    };
+
+    // 4. 反向可达性分析：K_i = {x | 存在允许的u，使 x + 2Δu ∈ K_{i+1}}，终点静止
+    std::vector<double> kLo(n + 1, 0.0), kHi(n + 1, 0.0);
+    std::vector<HalfPlane> planes;
+    for (int i = n - 1; i >= 0; --i) {
+        segmentPlanes(i, planes);
+        planes.push_back({1.0, 2.0 * delta, kHi[i + 1]});
+        planes.push_back({-1.0, -2.0 * delta, -kLo[i + 1]});
+        if (!extremeX(planes, true, kHi[i]) || !extremeX(planes, false, kLo[i])) {
+            setError(error, "路径在s=" + std::to_string(i * delta) + "处不可行 (静态力矩超限)");
+            return false;
+        }
+        kHi[i] = std::min(std::max(kHi[i], 0.0), grid[i].xMax);
+        kLo[i] = std::min(std::max(kLo[i], 0.0), kHi[i]);
+    }
+    if (kLo[0] > kTolerance) {
+        setError(error, "无法从静止出发");
+        return false;
+    }
+
+    // 5. 正向贪心：每段取最大加速度，同时停留在可控集合内
+    std::vector<double> x(n + 1, 0.0), u(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        const GridConstraint& g0 = grid[i];
+        const GridConstraint& g1 = grid[i + 1];
+        double uMin = -std::numeric_limits<double>::infinity();
+        double uMax = std::numeric_limits<double>::infinity();
+        const bool feasible =
+            narrowAcceleration(g0.a, g0.b * x[i] + g0.c, tauMax, uMin, uMax) &&
+            narrowAcceleration(g1.a + 2.0 * delta * g1.b, g1.b * x[i] + g1.c, tauMax, uMin, uMax);
+        if (!feasible) {
+            uMax = (kLo[i + 1] - x[i]) / (2.0 * delta);  // 数值误差，退回到可控集合下界
+        }
+        x[i + 1] = std::clamp(x[i] + 2.0 * delta * uMax, kLo[i + 1], kHi[i + 1]);
+        u[i] = (x[i + 1] - x[i]) / (2.0 * delta);
+    }
+
+    // 6. 网格时刻：段内匀加速，Δt = 2Δ / (√x_i + √x_{i+1})
+    std::vector<double> t(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) {
+        const double speedSum = std::sqrt(x[i]) + std::sqrt(x[i + 1]);
+        if (speedSum < 1e-12) {
+            setError(error, "路径速度为0，无法参数化");
+            return false;
+        }
+        t[i + 1] = t[i] + 2.0 * delta / speedSum;
+    }
+    const double duration = t[n];
+
+    if (result) {
+        result->duration = static_cast<float>(duration);
+        result->s.resize(n + 1);
+        result->sd.resize(n + 1);
+        result->t.resize(n + 1);
+        result->velocityLimitedPoints = 0;
+        result->torqueLimitedPoints = 0;
+        for (int i = 0; i <= n; ++i) {
+            result->s[i] = static_cast<float>(i * delta);
+            result->sd[i] = static_cast<float>(std::sqrt(x[i]));
+            result->t[i] = static_cast<float>(t[i]);
+
+            if (x[i] >= grid[i].xMax * (1.0 - 1e-3)) {
+                ++result->velocityLimitedPoints;
+            } else if (i < n) {
+                const Eigen::Vector3d tau = grid[i].a * u[i] + grid[i].b * x[i] + grid[i].c;
+                if (((tau.cwiseAbs() - tauMax * 0.99).array() >= 0.0).any()) {
+                    ++result->torqueLimitedPoints;
+                }
+            }
+        }
+    }
+
+    // 7. 按输出步长重采样为关节空间轨迹表，网格之间用Hermite插值q(s)
+    const float dt = options_.outputDt;
+    const size_t count = static_cast<size_t>(std::lround(duration / dt)) + 1;
+    table.resize(count, dt);
+    table.setSpace(TrajectorySpace::Joint);
+
+    int seg = 0;
+    for (size_t k = 0; k < count; ++k) {
+        const double tk = std::min(static_cast<double>(k) * dt, duration);
+        while (seg < n - 1 && t[seg + 1] <= tk) {
+            ++seg;
+        }
+        const double tau = tk - t[seg];
+        const double sd0 = std::sqrt(x[seg]);
+        const double s = std::clamp(seg * delta + sd0 * tau + 0.5 * u[seg] * tau * tau,
+                                    seg * delta, (seg + 1) * delta);
+        const double sd = std::max(sd0 + u[seg] * tau, 0.0);
+
+        const float r = static_cast<float>((s - seg * delta) / delta);
+        const float r2 = r * r, r3 = r2 * r;
+        const float h = static_cast<float>(delta);
+        const Vector3f position = (2 * r3 - 3 * r2 + 1) * q[seg] + (r3 - 2 * r2 + r) * h * dq[seg] +
+                                  (-2 * r3 + 3 * r2) * q[seg + 1] + (r3 - r2) * h * dq[seg + 1];
+        const Vector3f slope = (1.0f - r) * dq[seg] + r * dq[seg + 1];
+        const Vector3f curvature = (1.0f - r) * ddq[seg] + r * ddq[seg + 1];
+
+        TrajectoryPoint point;
+        point.position = position;
+        if (k + 1 < count) {
+            point.velocity = slope * static_cast<float>(sd);
+            point.acceleration = slope * static_cast<float>(u[seg]) + curvature * static_cast<float>(sd * sd);
+        }
+        table.setPoint(k, point);
+    }
+
+    return true;
+}
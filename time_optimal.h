@@ -0,0 +1,75 @@
+#ifndef TIME_OPTIMAL_H
+#define TIME_OPTIMAL_H
+
+#include "damiao.h"
+#include "robot_common.h"
+#include "robot_model.h"
+#include "trajectory_store.h"
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 时间最优路径参数化 (TOPP，可达性分析)
+ *
+ * 给定关节空间几何路径 q(s), s∈[0,1]，在电机速度(DQ_MAX)和力矩(TAU_MAX)约束下
+ * 求最快的 s(t)。以 x = ṡ²、u = s̈ 为变量，力矩对 (u, x) 是线性的：
+ *     τ = a(s)·u + b(s)·x + c(s)
+ * 系数由 RobotModel::computeTorqueDecoupled 求得。先反向计算每个网格点的可控集合，
+ * 再正向贪心取最大 ṡ，最后按输出步长重采样成关节空间轨迹表。
+ */
+class TimeOptimalParameterizer
+{
+public:
+    using JointPath = std::function<bool(float s, Vector3f& q)>;  // s∈[0,1] -> 关节角 (rad)，失败返回false
+
+    struct Options
+    {
+        std::array<damiao::Limit_param, 3> limits;  // 各关节电机限幅
+        float limitScale = 0.8f;   // 实际使用的限幅比例 (留出反馈控制余量)
+        int gridSize = 1000;       // 路径离散段数
+        float outputDt = 0.001f;   // 输出轨迹表时间步长 (秒)
+
+        Options() : limits(motorLimits(damiao::DM4310, damiao::DM4310, damiao::DM4310)) {}
+    };
+
+    struct Result
+    {
+        float duration = 0.0f;          // 最优总时长 (秒)
+        std::vector<float> s;           // 网格点路径参数
+        std::vector<float> sd;          // 网格点路径速度 ṡ
+        std::vector<float> t;           // 到达网格点的时刻
+        int velocityLimitedPoints = 0;  // 受速度约束的网格点数
+        int torqueLimitedPoints = 0;    // 受力矩约束的网格点数
+    };
+
+    /**
+     * @brief 按电机型号取damiao::limit_param中的限幅
+     */
+    static std::array<damiao::Limit_param, 3> motorLimits(damiao::DM_Motor_Type joint1,
+                                                          damiao::DM_Motor_Type joint2,
+                                                          damiao::DM_Motor_Type joint3);
+
+    explicit TimeOptimalParameterizer(const Options& options = Options()) : options_(options) {}
+
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& options() const { return options_; }
+
+    /**
+     * @brief 计算时间最优参数化并生成关节空间轨迹表
+     * @param path 关节空间几何路径，路径两端速度为0
+     * @param model 动力学模型
+     * @param table 输出轨迹表 (Float32，关节空间)
+     * @param result 网格上的参数化结果 (可为空)
+     * @param error 失败时的错误信息 (可为空)
+     * @return 路径在限幅内是否可行
+     */
+    bool parameterize(const JointPath& path, const RobotModel& model, TrajectoryStore& table,
+                      Result* result = nullptr, std::string* error = nullptr) const;
+
+private:
+    Options options_;
+};
+
+#endif // TIME_OPTIMAL_H
@@ -0,0 +1,254 @@
+#include "trace_log.h"
+#include "monotonic_clock.h"
+#include "spsc_ring.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief 一个写入线程的记录队列；线程退出后标记为空闲，可被新线程复用
+ */
+struct TraceThreadBuffer
+{
+    SpscRing<TraceRecord> ring{TraceLog::kRingCapacity, false};
+    std::atomic_bool active{true};
+    uint32_t index = 0;
+    TraceThreadBuffer *next = nullptr;  // 发布前设置，之后不再修改
+    std::atomic<uint64_t> written{0};   // 只有写入线程修改
+    std::atomic<uint64_t> dropped{0};
+};
+
+namespace {
+
+// 线程退出时释放其队列 (队列本身归TraceLog所有，剩余记录仍由消费线程取走)
+struct ThreadSlot
+{
+    TraceThreadBuffer *buffer = nullptr;
+
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            buffer->active.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+void bump(std::atomic<uint64_t> &counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void appendHex(std::string &line, const uint8_t *data, size_t size)
+{
+    static const char kDigits[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < size; ++i) {
+        line += kDigits[data[i] >> 4];
+        line += kDigits[data[i] & 0x0F];
+        line += ' ';
+    }
+}
+
+} // namespace
+
+std::atomic<uint8_t> TraceLog::level_{static_cast<uint8_t>(TraceLevel::Info)};
+
+TraceLog &TraceLog::instance()
+{
+    static TraceLog log;
+    return log;
+}
+
+TraceLog::~TraceLog()
+{
+    stop();
+    TraceThreadBuffer *buffer = buffers_.load(std::memory_order_acquire);
+    while (buffer) {
+        TraceThreadBuffer *next = buffer->next;
+        delete buffer;
+        buffer = next;
+    }
+}
+
+TraceThreadBuffer *TraceLog::threadBuffer()
+{
+    if (threadSlot.buffer) {
+        return threadSlot.buffer;
+    }
+    // 复用已退出线程的队列：旧写者已不存在，CAS保证只有一个新线程接手，单生产者约束仍成立
+    for (TraceThreadBuffer *buffer = buffers_.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        bool active = false;
+        if (buffer->active.compare_exchange_strong(active, true, std::memory_order_acquire)) {
+            threadSlot.buffer = buffer;
+            return buffer;
+        }
+    }
+    TraceThreadBuffer *buffer = new TraceThreadBuffer;
+    buffer->index = bufferCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    buffer->next = buffers_.load(std::memory_order_relaxed);
+    while (!buffers_.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    threadSlot.buffer = buffer;
+    return buffer;
+}
+
+void TraceLog::write(TraceLevel level, TraceEvent event, const void *payload, size_t size)
+{
+    TraceThreadBuffer *buffer = threadBuffer();
+
+    TraceRecord record;
+    record.timestampNs = Clock::now();
+    record.event = static_cast<uint16_t>(event);
+    record.level = static_cast<uint8_t>(level);
+    record.size = static_cast<uint8_t>(std::min(size, sizeof(record.payload)));
+    record.thread = buffer->index;
+    std::memcpy(record.payload, payload, record.size);
+
+    if (buffer->ring.push(record)) {
+        bump(buffer->written);
+    } else {
+        bump(buffer->dropped);
+    }
+}
+
+void TraceLog::setSink(Sink sink)
+{
+    sink_ = std::move(sink);
+}
+
+void TraceLog::start(int64_t periodNs)
+{
+    if (running_.exchange(true)) {
+        return;
+    }
+    consumer_ = std::thread([this, periodNs]() { run(periodNs); });
+}
+
+void TraceLog::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (consumer_.joinable()) {
+        consumer_.join();
+    }
+    drain();
+}
+
+void TraceLog::run(int64_t periodNs)
+{
+    // 只在CPU空闲时运行，不与接收/解析/控制线程争抢
+    sched_param idle{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle) != 0) {
+        std::fprintf(stderr, "跟踪日志线程无法设为SCHED_IDLE，以普通优先级运行\n");
+    }
+
+    MonotonicClock clock;
+    while (running_.load()) {
+        drain();
+        clock.sleepUntil(clock.nowNs() + periodNs);
+    }
+}
+
+size_t TraceLog::drain()
+{
+    pending_.clear();
+    TraceRecord records[64];
+    for (TraceThreadBuffer *buffer = buffers_.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        size_t count;
+        while ((count = buffer->ring.popBatch(records, 64)) > 0) {
+            pending_.insert(pending_.end(), records, records + count);
+        }
+    }
+    if (pending_.empty()) {
+        return 0;
+    }
+
+    // 各线程的队列各自有序，合并后按时间戳排序
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const TraceRecord &a, const TraceRecord &b) { return a.timestampNs < b.timestampNs; });
+
+    const size_t lines = std::min(pending_.size(), kMaxLinesPerDrain);
+    std::string text;
+    text.reserve(lines * 80);
+    for (size_t i = 0; i < lines; ++i) {
+        if (i > 0) {
+            text += '\n';
+        }
+        text += format(pending_[i]);
+    }
+    if (pending_.size() > lines) {
+        char note[96];
+        std::snprintf(note, sizeof(note), "\n(本批另有%zu条跟踪记录未显示)", pending_.size() - lines);
+        text += note;
+        suppressed_.fetch_add(pending_.size() - lines, std::memory_order_relaxed);
+    }
+    formatted_.fetch_add(lines, std::memory_order_relaxed);
+
+    if (sink_) {
+        sink_(text);
+    }
+    return pending_.size();
+}
+
+TraceLog::Stats TraceLog::stats() const
+{
+    Stats stats;
+    for (TraceThreadBuffer *buffer = buffers_.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        stats.written += buffer->written.load(std::memory_order_relaxed);
+        stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    stats.formatted = formatted_.load(std::memory_order_relaxed);
+    stats.suppressed = suppressed_.load(std::memory_order_relaxed);
+    stats.threads = static_cast<int>(bufferCount_.load(std::memory_order_relaxed));
+    return stats;
+}
+
+const char *TraceLog::levelName(TraceLevel level)
+{
+    switch (level) {
+    case TraceLevel::Debug:
+        return "debug";
+    case TraceLevel::Info:
+        return "info";
+    case TraceLevel::Warn:
+        return "warn";
+    case TraceLevel::Error:
+        return "error";
+    case TraceLevel::Off:
+        break;
+    }
+    return "off";
+}
+
+std::string TraceLog::format(const TraceRecord &record)
+{
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "[%.6f T%u] ", Clock::toSeconds(record.timestampNs), record.thread);
+    std::string line(prefix);
+
+    switch (static_cast<TraceEvent>(record.event)) {
+    case TraceEvent::CanFrame:
+        line += "CAN Frame: ";
+        appendHex(line, record.payload, record.size);
+        break;
+    case TraceEvent::AckFiltered:
+        line += "ACK filtered: ";
+        appendHex(line, record.payload, record.size);
+        break;
+    default:
+        line += "event ";
+        line += std::to_string(record.event);
+        line += ": ";
+        appendHex(line, record.payload, record.size);
+        break;
+    }
+    if (!line.empty() && line.back() == ' ') {
+        line.pop_back();
+    }
+    return line;
+}
@@ -0,0 +1,159 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 跟踪级别，低于当前级别的记录在调用处直接跳过
+ */
+enum class TraceLevel : uint8_t
+{
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+/**
+ * @brief 跟踪事件类型，决定负载的含义和格式化方式
+ */
+enum class TraceEvent : uint16_t
+{
+    CanFrame,       // 负载：16字节CAN帧
+    AckFiltered     // 负载：16字节ACK帧
+};
+
+/**
+ * @brief 定长二进制跟踪记录 (一个缓存行)，写入时不做任何格式化
+ */
+struct TraceRecord
+{
+    int64_t timestampNs = 0;   // Clock::now()
+    uint16_t event = 0;
+    uint8_t level = 0;
+    uint8_t size = 0;          // 负载字节数
+    uint32_t thread = 0;       // 写入线程的编号 (注册顺序)
+    uint8_t payload[48];
+};
+
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord应为一个缓存行");
+
+struct TraceThreadBuffer;
+
+/**
+ * @brief 异步二进制跟踪日志
+ *
+ * 每个写入线程拥有一个自己的无锁SPSC环形队列，线程启动时用registerThread()预先注册
+ * (未注册的线程在首次写入时注册，这一次会分配内存)；注册后写入只拷贝一条定长记录，
+ * 不加锁、不分配内存、不做系统调用，队列满时丢弃并计数。
+ * 队列挂在只增不减的无锁链表上，注册和遍历都不加锁，写入线程不会等待消费线程。
+ * 低优先级 (SCHED_IDLE) 的消费线程周期性取空所有线程的队列，按时间戳合并、格式化成文本，
+ * 整批交给输出回调 (例如排队追加到界面日志框)。
+ * 级别为全局原子量，可在运行中调整；被关闭的级别在调用处只有一次relaxed读取和比较。
+ */
+class TraceLog
+{
+public:
+    static constexpr size_t kRingCapacity = 1024;     // 每个线程的记录数
+    static constexpr size_t kMaxLinesPerDrain = 500;  // 每批最多输出的行数，其余只计数
+
+    using Sink = std::function<void(const std::string &lines)>;
+
+    struct Stats
+    {
+        uint64_t written = 0;     // 进入队列的记录
+        uint64_t dropped = 0;     // 队列满丢弃的记录
+        uint64_t formatted = 0;   // 已格式化输出的记录
+        uint64_t suppressed = 0;  // 超出每批行数上限未输出的记录
+        int threads = 0;          // 注册过的写入线程
+    };
+
+    static TraceLog &instance();
+
+    static bool enabled(TraceLevel level)
+    {
+        return static_cast<uint8_t>(level) >= level_.load(std::memory_order_relaxed);
+    }
+    static void setLevel(TraceLevel level) { level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+    static TraceLevel level() { return static_cast<TraceLevel>(level_.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief 为调用线程注册队列 (写入线程启动时调用，使首次写入不再分配内存)；重复调用无副作用
+     */
+    void registerThread() { threadBuffer(); }
+
+    /**
+     * @brief 写入一条记录 (任意线程)；负载超过48字节的部分截断。通常经TRACE_EVENT宏调用
+     */
+    void write(TraceLevel level, TraceEvent event, const void *payload, size_t size);
+
+    /**
+     * @brief 设置输出回调 (在消费线程中调用)；只能在start()之前或stop()之后设置
+     */
+    void setSink(Sink sink);
+
+    /**
+     * @brief 启动消费线程，每periodNs取空一次
+     */
+    void start(int64_t periodNs = 50000000);
+
+    /**
+     * @brief 停止消费线程，并输出剩余的记录
+     */
+    void stop();
+
+    /**
+     * @brief 取空全部线程的队列并格式化输出 (消费线程未运行时可直接调用)
+     * @return 取出的记录数
+     */
+    size_t drain();
+
+    Stats stats() const;
+
+    static const char *levelName(TraceLevel level);
+
+    /**
+     * @brief 把一条记录格式化成一行文本 (不含换行)
+     */
+    static std::string format(const TraceRecord &record);
+
+    ~TraceLog();
+
+private:
+    TraceLog() = default;
+    TraceLog(const TraceLog &) = delete;
+    TraceLog &operator=(const TraceLog &) = delete;
+
+    TraceThreadBuffer *threadBuffer();
+    void run(int64_t periodNs);
+
+    static std::atomic<uint8_t> level_;
+
+    std::atomic<TraceThreadBuffer *> buffers_{nullptr};  // 各线程队列的链表头，只在头部插入，析构时释放
+    std::atomic<uint32_t> bufferCount_{0};
+    std::vector<TraceRecord> pending_;  // 消费线程：本批取出的记录
+    Sink sink_;
+    std::thread consumer_;
+    std::atomic_bool running_{false};
+    std::atomic<uint64_t> formatted_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+/**
+ * @brief 写入跟踪记录；级别被关闭时不求值负载参数，只有一次原子读取和比较
+ */
+#define TRACE_EVENT(level, event, payload, size)                                    \
+    do {                                                                            \
+        if (TraceLog::enabled(level)) {                                             \
+            TraceLog::instance().write((level), (event), (payload), (size));        \
+        }                                                                           \
+    } while (0)
+
+#endif // TRACE_LOG_H
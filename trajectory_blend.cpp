@@ -0,0 +1,176 @@
+#include "trajectory_blend.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kMinDuration = 1e-3f;
+constexpr int kBisectionSteps = 24;
+constexpr int kRootBisectionSteps = 48;  // 单调区间上求加速度零点
+
+// a·t² + b·t + c = 0 在 (lo, hi) 内的实根，按升序写入roots，返回个数
+int quadraticRoots(double a, double b, double c, double lo, double hi, double roots[2])
+{
+    double r[2];
+    int count = 0;
+    if (std::abs(a) < 1e-12) {
+        if (std::abs(b) > 1e-12) {
+            r[count++] = -c / b;
+        }
+    } else {
+        const double disc = b * b - 4.0 * a * c;
+        if (disc >= 0.0) {
+            // 避免相减抵消的求根公式
+            const double q = -0.5 * (b + std::copysign(std::sqrt(disc), b));
+            r[count++] = q / a;
+            if (q != 0.0) {
+                r[count++] = c / q;
+            }
+        }
+    }
+    if (count == 2 && r[0] > r[1]) {
+        std::swap(r[0], r[1]);
+    }
+    int inside = 0;
+    for (int i = 0; i < count; ++i) {
+        if (r[i] > lo && r[i] < hi) {
+            roots[inside++] = r[i];
+        }
+    }
+    return inside;
+}
+
+} // namespace
+
+void TrajectoryBlend::solve(float duration)
+{
+    duration_ = duration;
+    const float T = duration;
+    const float T2 = T * T, T3 = T2 * T, T4 = T3 * T, T5 = T4 * T;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const float p0 = from_.position[axis], v0 = from_.velocity[axis], a0 = from_.acceleration[axis];
+        const float p1 = to_.position[axis], v1 = to_.velocity[axis], a1 = to_.acceleration[axis];
+        std::array<float, 6>& c = c_[axis];
+        c[0] = p0;
+        c[1] = v0;
+        c[2] = 0.5f * a0;
+        c[3] = (20.0f * (p1 - p0) - (8.0f * v1 + 12.0f * v0) * T - (3.0f * a0 - a1) * T2) / (2.0f * T3);
+        c[4] = (30.0f * (p0 - p1) + (14.0f * v1 + 16.0f * v0) * T + (3.0f * a0 - 2.0f * a1) * T2) / (2.0f * T4);
+        c[5] = (12.0f * (p1 - p0) - 6.0f * (v1 + v0) * T - (a0 - a1) * T2) / (2.0f * T5);
+    }
+}
+
+bool TrajectoryBlend::withinLimits(const Limits& limits) const
+{
+    const float T = duration_;
+    for (int axis = 0; axis < 3; ++axis) {
+        const std::array<float, 6>& c = c_[axis];
+
+        // 加加速度为二次式 6c3 + 24c4τ + 60c5τ²，极值在端点或顶点
+        auto jerk = [&c](float t) { return 6.0f * c[3] + t * (24.0f * c[4] + t * 60.0f * c[5]); };
+        float peakJerk = std::max(std::abs(jerk(0.0f)), std::abs(jerk(T)));
+        if (std::abs(c[5]) > 1e-12f) {
+            const float vertex = -24.0f * c[4] / (120.0f * c[5]);
+            if (vertex > 0.0f && vertex < T) {
+                peakJerk = std::max(peakJerk, std::abs(jerk(vertex)));
+            }
+        }
+        if (peakJerk > limits.maxJerk) {
+            return false;
+        }
+
+        // 加速度 (三次式) 的极值在端点或加加速度的实根处；这些点把[0, T]分成加速度单调的区间
+        auto velocity = [&c](double t) {
+            return c[1] + t * (2.0 * c[2] + t * (3.0 * c[3] + t * (4.0 * c[4] + t * 5.0 * c[5])));
+        };
+        auto acceleration = [&c](double t) { return 2.0 * c[2] + t * (6.0 * c[3] + t * (12.0 * c[4] + t * 20.0 * c[5])); };
+        double knots[4] = {0.0};
+        int knotCount = 1;
+        knotCount += quadraticRoots(60.0 * c[5], 24.0 * c[4], 6.0 * c[3], 0.0, T, knots + 1);
+        knots[knotCount++] = T;
+
+        // 速度的极值在端点或加速度的实根处：每个单调区间内至多一个，变号时二分求出
+        double peakVelocity = 0.0;
+        double peakAcceleration = 0.0;
+        for (int i = 0; i < knotCount; ++i) {
+            peakVelocity = std::max(peakVelocity, std::abs(velocity(knots[i])));
+            peakAcceleration = std::max(peakAcceleration, std::abs(acceleration(knots[i])));
+        }
+        for (int i = 0; i + 1 < knotCount; ++i) {
+            double lo = knots[i], hi = knots[i + 1];
+            const double aLo = acceleration(lo);
+            if ((aLo > 0.0) == (acceleration(hi) > 0.0)) {
+                continue;
+            }
+            for (int k = 0; k < kRootBisectionSteps; ++k) {
+                const double mid = 0.5 * (lo + hi);
+                if ((acceleration(mid) > 0.0) == (aLo > 0.0)) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+            peakVelocity = std::max(peakVelocity, std::abs(velocity(0.5 * (lo + hi))));
+        }
+        if (peakVelocity > limits.maxVelocity || peakAcceleration > limits.maxAcceleration) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TrajectoryBlend::plan(const TrajectoryPoint& from, const TrajectoryPoint& to, const Limits& limits)
+{
+    from_ = from;
+    to_ = to;
+
+    // 倍增找到可行上界，再二分收缩到最短可行时长
+    float lo = kMinDuration;
+    float hi = kMinDuration;
+    solve(hi);
+    while (!withinLimits(limits)) {
+        lo = hi;
+        hi *= 2.0f;
+        if (hi > kMaxDuration) {
+            // 无解时不留下可执行的过渡段：保持在起点
+            to_ = from_;
+            c_ = {};
+            duration_ = 0.0f;
+            return false;
+        }
+        solve(hi);
+    }
+    if (hi == kMinDuration) {
+        return true;
+    }
+    for (int i = 0; i < kBisectionSteps; ++i) {
+        const float mid = 0.5f * (lo + hi);
+        solve(mid);
+        if (withinLimits(limits)) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    solve(hi);
+    return true;
+}
+
+TrajectoryPoint TrajectoryBlend::evaluate(float tau) const
+{
+    if (tau >= duration_) {
+        return to_;
+    }
+    const float t = std::max(tau, 0.0f);
+
+    TrajectoryPoint point;
+    for (int axis = 0; axis < 3; ++axis) {
+        const std::array<float, 6>& c = c_[axis];
+        point.position[axis] = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+        point.velocity[axis] = c[1] + t * (2.0f * c[2] + t * (3.0f * c[3] + t * (4.0f * c[4] + t * 5.0f * c[5])));
+        point.acceleration[axis] = 2.0f * c[2] + t * (6.0f * c[3] + t * (12.0f * c[4] + t * 20.0f * c[5]));
+    }
+    return point;
+}
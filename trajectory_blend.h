@@ -0,0 +1,50 @@
+#ifndef TRAJECTORY_BLEND_H
+#define TRAJECTORY_BLEND_H
+
+#include "robot_common.h"
+#include <array>
+
+/**
+ * @brief 两个运动状态之间的五次多项式过渡段 (各轴共用时长)
+ *
+ * 起止位置、速度、加速度均连续；时长取满足速度/加速度/加加速度限制的最短值。
+ * 规划只涉及固定次数的求值和二分，耗时远小于一个控制周期，可在控制线程中直接调用。
+ */
+class TrajectoryBlend
+{
+public:
+    struct Limits
+    {
+        float maxVelocity = 10.0f;       // 单位/s
+        float maxAcceleration = 50.0f;   // 单位/s²
+        float maxJerk = 1000.0f;         // 单位/s³
+    };
+
+    TrajectoryBlend() = default;
+
+    /**
+     * @brief 规划从from到to的过渡段
+     * @return 是否在最长时长内找到满足限制的解；无解时时长为0，evaluate()返回起点，调用方应放弃本次过渡
+     */
+    bool plan(const TrajectoryPoint& from, const TrajectoryPoint& to, const Limits& limits);
+
+    /**
+     * @brief 过渡段上τ时刻的状态 (τ超出[0, duration]时钳位)
+     */
+    TrajectoryPoint evaluate(float tau) const;
+
+    float duration() const { return duration_; }
+
+    static constexpr float kMaxDuration = 10.0f;  // 过渡段最长时长 (秒)
+
+private:
+    void solve(float duration);
+    bool withinLimits(const Limits& limits) const;
+
+    TrajectoryPoint from_;
+    TrajectoryPoint to_;
+    std::array<std::array<float, 6>, 3> c_{};  // 各轴五次多项式系数
+    float duration_ = 0.0f;
+};
+
+#endif // TRAJECTORY_BLEND_H
@@ -0,0 +1,194 @@
+#include "trajectory_cache.h"
+#include "trajectory_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+TrajectoryCache::TrajectoryCache(size_t memoryBudgetBytes, const std::string& directory)
+    : memoryBudget_(memoryBudgetBytes)
+{
+    setDirectory(directory);
+}
+
+TrajectoryCache::~TrajectoryCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    writeReady_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();  // 写完剩余文件再退出
+    }
+}
+
+void TrajectoryCache::setDirectory(const std::string& directory)
+{
+    std::error_code ec;
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, ec);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = ec ? std::string() : directory;  // 目录不可用时退化为纯内存缓存
+}
+
+std::string TrajectoryCache::directory() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directory_;
+}
+
+std::string TrajectoryCache::defaultDirectory()
+{
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        return std::string(xdg) + "/robotic_arm/trajectories";
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.cache/robotic_arm/trajectories";
+    }
+    return std::string();
+}
+
+std::string TrajectoryCache::pathFor(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.traj", static_cast<unsigned long long>(key));
+    return directory_ + "/" + name;
+}
+
+bool TrajectoryCache::lookup(uint64_t key, TrajectoryStore& store)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            store = it->second->second;
+            ++stats_.memoryHits;
+            return true;
+        }
+        if (directory_.empty()) {
+            ++stats_.misses;
+            return false;
+        }
+        path = pathFor(key);
+    }
+
+    // 映射文件不持锁，避免阻塞其他查询
+    TrajectoryStore mapped;
+    uint64_t fileHash = 0;
+    const bool ok = TrajectoryFile::map(path, mapped, &fileHash) && fileHash == key;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.diskHits;
+    insertMemory(key, mapped);
+    store = mapped;
+    return true;
+}
+
+void TrajectoryCache::insert(uint64_t key, const TrajectoryStore& store)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        insertMemory(key, store);
+        if (directory_.empty()) {
+            return;
+        }
+        // 同一键尚未写出时只保留最新的表
+        PendingWrite write{key, pathFor(key), store};
+        auto it = std::find_if(writes_.begin(), writes_.end(),
+                               [key](const PendingWrite& pending) { return pending.key == key; });
+        if (it != writes_.end()) {
+            *it = std::move(write);
+        } else {
+            writes_.push_back(std::move(write));
+        }
+        if (!writer_.joinable()) {
+            writer_ = std::thread(&TrajectoryCache::writeLoop, this);
+        }
+    }
+    writeReady_.notify_one();
+}
+
+void TrajectoryCache::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    writesDone_.wait(lock, [this]() { return writes_.empty() && !writing_; });
+}
+
+void TrajectoryCache::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        writeReady_.wait(lock, [this]() { return stopping_ || !writes_.empty(); });
+        if (writes_.empty()) {
+            return;  // 已停止且无剩余
+        }
+        PendingWrite write = std::move(writes_.front());
+        writes_.pop_front();
+        writing_ = true;
+        lock.unlock();
+
+        // 原子rename写入，同一目录可被多个进程共享
+        TrajectoryFile::write(write.path, write.store, write.key);
+
+        lock.lock();
+        writing_ = false;
+        if (writes_.empty()) {
+            writesDone_.notify_all();
+        }
+    }
+}
+
+void TrajectoryCache::insertMemory(uint64_t key, const TrajectoryStore& store)
+{
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        memoryBytes_ -= it->second->second.byteSize();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+
+    lru_.emplace_front(key, store);
+    index_[key] = lru_.begin();
+    memoryBytes_ += store.byteSize();
+    evict();
+}
+
+void TrajectoryCache::evict()
+{
+    // 至少保留最近一项，即使它超出预算
+    while (memoryBytes_ > memoryBudget_ && lru_.size() > 1) {
+        const Entry& victim = lru_.back();
+        memoryBytes_ -= victim.second.byteSize();
+        index_.erase(victim.first);
+        lru_.pop_back();
+    }
+}
+
+void TrajectoryCache::clearMemory()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    memoryBytes_ = 0;
+}
+
+TrajectoryCache::Stats TrajectoryCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.memoryBytes = memoryBytes_;
+    s.entries = lru_.size();
+    return s;
+}
@@ -0,0 +1,110 @@
+#ifndef TRAJECTORY_CACHE_H
+#define TRAJECTORY_CACHE_H
+
+#include "trajectory_store.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief 按参数哈希寻址的轨迹表缓存 (内存LRU + 磁盘文件)
+ *
+ * 键为trajectoryConfigHash(RobotParams, TrajectoryParams, dt)，含生成算法版本号。
+ * 内存层按字节预算做LRU淘汰；磁盘层把表写成轨迹文件，重启后以mmap加载。
+ * 写文件由后台线程完成，插入方 (界面/控制线程) 不做文件IO；析构时写完剩余文件。
+ * 线程安全。
+ */
+class TrajectoryCache
+{
+public:
+    struct Stats
+    {
+        uint64_t memoryHits = 0;
+        uint64_t diskHits = 0;
+        uint64_t misses = 0;
+        size_t memoryBytes = 0;
+        size_t entries = 0;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param memoryBudgetBytes 内存层字节预算
+     * @param directory 磁盘缓存目录，空字符串表示不落盘
+     */
+    explicit TrajectoryCache(size_t memoryBudgetBytes = 64u << 20,
+                             const std::string& directory = std::string());
+    ~TrajectoryCache();
+
+    TrajectoryCache(const TrajectoryCache&) = delete;
+    TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
+    /**
+     * @brief 查找轨迹表，依次查询内存和磁盘
+     * @return 是否命中
+     */
+    bool lookup(uint64_t key, TrajectoryStore& store);
+
+    /**
+     * @brief 插入轨迹表 (内存，以及磁盘目录已设置时排队由后台线程写入文件)
+     */
+    void insert(uint64_t key, const TrajectoryStore& store);
+
+    /**
+     * @brief 等待已排队的文件全部写完
+     */
+    void flush();
+
+    /**
+     * @brief 清空内存层 (磁盘文件保留)
+     */
+    void clearMemory();
+
+    void setDirectory(const std::string& directory);
+    std::string directory() const;
+
+    Stats stats() const;
+
+    /**
+     * @brief 默认缓存目录: $XDG_CACHE_HOME/robotic_arm/trajectories 或 ~/.cache/robotic_arm/trajectories
+     */
+    static std::string defaultDirectory();
+
+private:
+    using Entry = std::pair<uint64_t, TrajectoryStore>;
+
+    struct PendingWrite
+    {
+        uint64_t key;
+        std::string path;
+        TrajectoryStore store;  // 共享存储，排队不拷贝数据
+    };
+
+    std::string pathFor(uint64_t key) const;
+    void insertMemory(uint64_t key, const TrajectoryStore& store);
+    void evict();
+    void writeLoop();
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // 队首为最近使用
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    size_t memoryBudget_;
+    size_t memoryBytes_ = 0;
+    std::string directory_;
+    Stats stats_;
+
+    // 后台写盘 (首次插入时启动)
+    std::deque<PendingWrite> writes_;
+    bool writing_ = false;
+    bool stopping_ = false;
+    std::condition_variable writeReady_;
+    std::condition_variable writesDone_;
+    std::thread writer_;
+};
+
+#endif // TRAJECTORY_CACHE_H
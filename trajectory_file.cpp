@@ -0,0 +1,276 @@
+#include "trajectory_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+static_assert(std::is_trivially_copyable<TrajectoryFileHeader>::value,
+              "TrajectoryFileHeader must be trivially copyable");
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'A', 'T', 'R', 'A', 'J', 0, 0};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void setError(std::string* error, const std::string& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+bool writeAll(int fd, const void* data, size_t len)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+class Fnv1a
+{
+public:
+    void bytes(const void* data, size_t len)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) {
+            hash_ ^= p[i];
+            hash_ *= 1099511628211ull;
+        }
+    }
+    void f(float value) { bytes(&value, sizeof(value)); }
+    void i(int32_t value) { bytes(&value, sizeof(value)); }
+    uint64_t value() const { return hash_; }
+
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+};
+
+} // namespace
+
+uint64_t trajectoryConfigHash(const RobotParams& robot, const TrajectoryParams& trajectory, float dt)
+{
+    Fnv1a h;
+
+    h.i(static_cast<int32_t>(kGeneratorVersion));
+    for (int j = 0; j < 3; ++j) {
+        h.f(robot.dh[j].alpha);
+        h.f(robot.dh[j].a);
+        h.f(robot.dh[j].d);
+        h.f(robot.dh[j].theta);
+        h.f(robot.m[j]);
+        for (int k = 0; k < 3; ++k) {
+            h.f(robot.rc[j][k]);
+        }
+        for (int k = 0; k < 9; ++k) {
+            h.f(robot.Ic[j](k));
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        h.f(robot.gravity[k]);
+    }
+
+    h.i(static_cast<int32_t>(trajectory.type));
+    h.i(static_cast<int32_t>(trajectory.storageEncoding));
+    h.f(trajectory.duration);
+    h.f(trajectory.spiralAmplitude);
+    h.f(trajectory.spiralRate);
+    h.f(trajectory.spiralX0);
+    h.f(trajectory.spiralY0);
+    h.f(trajectory.spiralZ0);
+    h.f(trajectory.spiralZRiseRate);
+    h.f(trajectory.sineAmplitude1);
+    h.f(trajectory.sineAmplitude2);
+    h.f(trajectory.sineAmplitude3);
+    h.f(trajectory.sineFrequency);
+    h.i(static_cast<int32_t>(trajectory.waypoints.size()));
+    for (const Vector3f& p : trajectory.waypoints) {
+        h.f(p[0]);
+        h.f(p[1]);
+        h.f(p[2]);
+    }
+    h.i(static_cast<int32_t>(trajectory.waypointTimes.size()));
+    for (float t : trajectory.waypointTimes) {
+        h.f(t);
+    }
+    h.i(static_cast<int32_t>(trajectory.waypointSpace));
+    h.i(static_cast<int32_t>(trajectory.splineKind));
+    h.i(static_cast<int32_t>(trajectory.pathShape));
+    h.f(trajectory.pathSpeed);
+    h.f(trajectory.pathAcceleration);
+    h.f(trajectory.pathTurns);
+    h.f(trajectory.pathEnd[0]);
+    h.f(trajectory.pathEnd[1]);
+    h.f(trajectory.pathEnd[2]);
+    h.f(dt);
+
+    return h.value();
+}
+
+bool TrajectoryFile::write(const std::string& path, const TrajectoryStore& store,
+                           uint64_t configHash, std::string* error)
+{
+    TrajectoryFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(TrajectoryFileHeader);
+    header.configHash = configHash;
+    header.sampleCount = store.size();
+    header.dt = store.dt();
+    header.encoding = static_cast<uint8_t>(store.encoding());
+    header.space = static_cast<uint8_t>(store.space());
+    header.channelCount = TrajectoryStore::kChannelCount;
+
+    const uint64_t channelBytes = store.size() * TrajectoryStore::elementSize(store.encoding());
+    uint64_t cursor = alignUp(sizeof(TrajectoryFileHeader), kPageAlignment);
+    for (int c = 0; c < TrajectoryStore::kChannelCount; ++c) {
+        const auto channel = static_cast<TrajectoryChannel>(c);
+        header.channelOffset[c] = cursor;
+        header.channelBytes[c] = channelBytes;
+        header.scale[c] = store.channelScale(channel);
+        header.offset[c] = store.channelOffset(channel);
+        header.errorBound[c] = store.errorBound(channel);
+        cursor = alignUp(cursor + channelBytes, kPageAlignment);
+    }
+
+    const std::string tmpPath = path + ".tmp." + std::to_string(::getpid());
+    const int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        setError(error, "open " + tmpPath + ": " + std::strerror(errno));
+        return false;
+    }
+
+    static const uint8_t zeros[kPageAlignment] = {};
+    bool ok = writeAll(fd, &header, sizeof(header));
+    uint64_t written = sizeof(header);
+    for (int c = 0; c < TrajectoryStore::kChannelCount && ok; ++c) {
+        // 填充到通道起始的页边界
+        while (ok && written < header.channelOffset[c]) {
+            const size_t pad = static_cast<size_t>(std::min<uint64_t>(header.channelOffset[c] - written, kPageAlignment));
+            ok = writeAll(fd, zeros, pad);
+            written += pad;
+        }
+        if (ok && channelBytes > 0) {
+            ok = writeAll(fd, store.rawChannel(static_cast<TrajectoryChannel>(c)), channelBytes);
+            written += channelBytes;
+        }
+    }
+    if (ok) {
+        // 末尾补齐，保证映射最后一页完整
+        ok = ::ftruncate(fd, static_cast<off_t>(cursor)) == 0;
+    }
+
+    if (!ok) {
+        setError(error, "write " + tmpPath + ": " + std::strerror(errno));
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    ::close(fd);
+    if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        setError(error, "rename " + path + ": " + std::strerror(errno));
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TrajectoryFile::map(const std::string& path, TrajectoryStore& store,
+                         uint64_t* configHash, std::string* error)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        setError(error, "open " + path + ": " + std::strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TrajectoryFileHeader)) {
+        setError(error, path + ": 文件过小或无法读取");
+        ::close(fd);
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    void* base = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // 映射建立后即可关闭描述符
+    if (base == MAP_FAILED) {
+        setError(error, "mmap " + path + ": " + std::strerror(errno));
+        return false;
+    }
+
+    std::shared_ptr<void> mapping(base, [fileSize](void* p) { ::munmap(p, fileSize); });
+
+    TrajectoryFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        setError(error, path + ": 不是轨迹文件");
+        return false;
+    }
+    if (header.version != kVersion || header.headerSize != sizeof(TrajectoryFileHeader)) {
+        setError(error, path + ": 不支持的文件版本 " + std::to_string(header.version));
+        return false;
+    }
+    if (header.channelCount != TrajectoryStore::kChannelCount ||
+        header.encoding > static_cast<uint8_t>(TrajectoryEncoding::Float16) ||
+        header.space > static_cast<uint8_t>(TrajectorySpace::Joint)) {
+        setError(error, path + ": 通道布局无效");
+        return false;
+    }
+
+    if (header.sampleCount > fileSize || !(header.dt > 0.0f)) {
+        setError(error, path + ": 采样点数或步长无效");
+        return false;
+    }
+
+    const auto encoding = static_cast<TrajectoryEncoding>(header.encoding);
+    const uint64_t expectedBytes = header.sampleCount * TrajectoryStore::elementSize(encoding);
+
+    std::array<const uint8_t*, TrajectoryStore::kChannelCount> channels{};
+    std::array<float, TrajectoryStore::kChannelCount> scale{};
+    std::array<float, TrajectoryStore::kChannelCount> offset{};
+    std::array<float, TrajectoryStore::kChannelCount> errorBound{};
+    for (int c = 0; c < TrajectoryStore::kChannelCount; ++c) {
+        if (header.channelBytes[c] != expectedBytes ||
+            header.channelOffset[c] % kPageAlignment != 0 ||
+            header.channelOffset[c] > fileSize ||
+            fileSize - header.channelOffset[c] < expectedBytes) {
+            setError(error, path + ": 通道" + std::to_string(c) + "越界");
+            return false;
+        }
+        channels[c] = static_cast<const uint8_t*>(base) + header.channelOffset[c];
+        scale[c] = header.scale[c];
+        offset[c] = header.offset[c];
+        errorBound[c] = header.errorBound[c];
+    }
+
+    store.attachExternal(std::move(mapping), channels, header.sampleCount, header.dt,
+                         encoding, scale, offset, errorBound);
+    store.setSpace(static_cast<TrajectorySpace>(header.space));
+
+    if (configHash) {
+        *configHash = header.configHash;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include "robot_common.h"
+#include "trajectory_store.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 二进制轨迹文件头 (小端，位于文件起始处)
+ *
+ * 文件布局: [头部, 填充到4096] [通道0, 4096对齐] ... [通道8, 4096对齐]
+ * 各通道即TrajectoryStore的原始编码数据，映射后可直接使用。
+ */
+struct TrajectoryFileHeader
+{
+    char magic[8];                  // "RATRAJ\0\0"
+    uint32_t version;               // 格式版本
+    uint32_t headerSize;            // sizeof(TrajectoryFileHeader)
+    uint64_t configHash;            // 生成该轨迹的RobotParams/TrajectoryParams/dt哈希，外部轨迹为0
+    uint64_t sampleCount;           // 采样点数
+    float dt;                       // 采样间隔 (秒)
+    uint8_t encoding;               // TrajectoryEncoding
+    uint8_t space;                  // TrajectorySpace (通道布局)
+    uint8_t channelCount;           // 通道数，当前为9
+    uint8_t reserved;
+    uint64_t channelOffset[TrajectoryStore::kChannelCount];  // 通道在文件中的偏移
+    uint64_t channelBytes[TrajectoryStore::kChannelCount];   // 通道有效字节数
+    float scale[TrajectoryStore::kChannelCount];
+    float offset[TrajectoryStore::kChannelCount];
+    float errorBound[TrajectoryStore::kChannelCount];
+};
+
+/**
+ * @brief 轨迹文件读写 (写入后以mmap只读方式零拷贝加载，可多进程共享)
+ */
+class TrajectoryFile
+{
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kPageAlignment = 4096;
+
+    /**
+     * @brief 写入轨迹文件 (先写临时文件再rename，读者不会看到半写的文件)
+     * @param path 文件路径
+     * @param store 轨迹表
+     * @param configHash 参数哈希，见trajectoryConfigHash
+     * @param error 失败时的错误信息 (可为空)
+     * @return 是否成功
+     */
+    static bool write(const std::string& path, const TrajectoryStore& store,
+                      uint64_t configHash, std::string* error = nullptr);
+
+    /**
+     * @brief 以只读mmap方式加载轨迹文件，不拷贝、不解析数据
+     * @param path 文件路径
+     * @param store 输出轨迹表 (持有映射直到最后一个拷贝析构)
+     * @param configHash 输出文件头中的参数哈希 (可为空)
+     * @param error 失败时的错误信息 (可为空)
+     * @return 是否成功
+     */
+    static bool map(const std::string& path, TrajectoryStore& store,
+                    uint64_t* configHash = nullptr, std::string* error = nullptr);
+};
+
+/**
+ * @brief 轨迹生成算法版本，参与配置哈希
+ *
+ * 修改螺旋线/样条/弧长路径/时间最优参数化等生成算法后加1，旧算法写出的缓存表和轨迹文件随之失效。
+ */
+constexpr uint32_t kGeneratorVersion = 2;
+
+/**
+ * @brief 计算轨迹配置哈希 (FNV-1a 64位，逐字段计算，与结构体填充无关，含kGeneratorVersion)
+ */
+uint64_t trajectoryConfigHash(const RobotParams& robot, const TrajectoryParams& trajectory, float dt);
+
+#endif // TRAJECTORY_FILE_H
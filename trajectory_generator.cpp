@@ -1,30 +1,347 @@
 #include "trajectory_generator.h"
+#include "trajectory_cache.h"
+#include "trajectory_file.h"
+#include <algorithm>
 #include <cmath>
 
-TrajectoryGenerator::TrajectoryGenerator(const TrajectoryParams& params)
+TrajectoryGenerator::TrajectoryGenerator(const TrajectoryParams& params,
+                                         std::shared_ptr<TrajectoryCache> cache)
     : params_(params)
+    , cache_(std::move(cache))
 {
-    precomputedSpiralTrajectory_ = generateTrajectory(0.001f);  // 预计算螺旋线轨迹，时间步长1ms
+    rebuildPrecomputed();  // 预计算螺旋线轨迹，时间步长1ms
+}
+
+uint32_t TrajectoryGenerator::parameterDependencies(const TrajectoryParams& from, const TrajectoryParams& to)
+{
+    uint32_t deps = DependsNone;
+
+    if (from.type != to.type || from.duration != to.duration) {
+        deps |= DependsShape;
+    }
+    if (from.storageEncoding != to.storageEncoding) {
+        deps |= DependsEncoding;
+    }
+
+    // 只有当前类型用到的参数才算依赖
+    switch (to.type) {
+    case TrajectoryType::Spiral:
+        if (from.spiralRate != to.spiralRate || from.spiralAmplitude != to.spiralAmplitude) {
+            deps |= DependsShape;
+        }
+        if (from.spiralX0 != to.spiralX0 || from.spiralY0 != to.spiralY0 || from.spiralZ0 != to.spiralZ0) {
+            deps |= DependsTranslation;
+        }
+        if (from.spiralZRiseRate != to.spiralZRiseRate) {
+            deps |= DependsZRise;
+        }
+        break;
+    case TrajectoryType::Sine:
+        if (from.sineAmplitude1 != to.sineAmplitude1 || from.sineAmplitude2 != to.sineAmplitude2 ||
+            from.sineAmplitude3 != to.sineAmplitude3 || from.sineFrequency != to.sineFrequency) {
+            deps |= DependsShape;
+        }
+        break;
+    case TrajectoryType::Waypoint:
+        if (from.waypoints != to.waypoints || from.waypointTimes != to.waypointTimes ||
+            from.waypointSpace != to.waypointSpace || from.splineKind != to.splineKind) {
+            deps |= DependsShape;
+        }
+        break;
+    case TrajectoryType::Path:
+        // 时长由路径长度和速度决定，duration不参与
+        deps &= ~DependsShape;
+        if (from.type != to.type || from.pathShape != to.pathShape || from.pathSpeed != to.pathSpeed ||
+            from.pathAcceleration != to.pathAcceleration ||
+            from.pathTurns != to.pathTurns || from.spiralAmplitude != to.spiralAmplitude ||
+            (to.pathShape == PathShape::Line && from.pathEnd != to.pathEnd)) {
+            deps |= DependsShape;
+        }
+        if (from.spiralX0 != to.spiralX0 || from.spiralY0 != to.spiralY0 || from.spiralZ0 != to.spiralZ0) {
+            // 直线的终点不随中心平移
+            deps |= to.pathShape == PathShape::Line ? DependsShape : DependsTranslation;
+        }
+        break;
+    }
+
+    return deps;
 }
 
 void TrajectoryGenerator::setParameters(const TrajectoryParams& params)
 {
-    // 判断是否需要重新预计算
-    bool needRecompute = (params.duration    != params_.duration)    ||
-                         (params.type        != params_.type)        ||
-                         (params.spiralRate  != params_.spiralRate)  ||
-                         (params.spiralAmplitude != params_.spiralAmplitude);
+    // 判断是否需要重新预计算，以及能否只做增量修补
+    const uint32_t deps = parameterDependencies(params_, params);
+    const TrajectoryParams previous = params_;
 
     params_ = params;  // 只赋值一次
 
-    if (needRecompute) {
-        precomputedSpiralTrajectory_ = generateTrajectory(0.001f);
+    if (deps == DependsNone || externalSource_) {
+        return;
+    }
+
+    if ((deps & (DependsShape | DependsEncoding)) || !patchPrecomputed(previous, deps)) {
+        rebuildPrecomputed();
     }
 }
 
+bool TrajectoryGenerator::patchPrecomputed(const TrajectoryParams& from, uint32_t deps)
+{
+    if (precomputed_.empty()) {
+        return false;
+    }
+
+    // 弧长路径按新中心重建 (时间最优参数化取其形状)，代价远小于重新生成轨迹表
+    if (deps & DependsTranslation) {
+        rebuildPath();
+    }
+
+    // 目标配置已缓存则直接取用
+    if (cache_ && cache_->lookup(trajectoryConfigHash(robotParams_, params_, kPrecomputeDt), precomputed_)) {
+        return true;
+    }
+
+    if (deps & DependsTranslation) {
+        precomputed_.addOffset(TrajectoryChannel::PosX, params_.spiralX0 - from.spiralX0);
+        precomputed_.addOffset(TrajectoryChannel::PosY, params_.spiralY0 - from.spiralY0);
+        precomputed_.addOffset(TrajectoryChannel::PosZ, params_.spiralZ0 - from.spiralZ0);
+    }
+    if (deps & DependsZRise) {
+        // z = z0 + rise * t, vz = rise
+        const float deltaRise = params_.spiralZRiseRate - from.spiralZRiseRate;
+        precomputed_.addRamp(TrajectoryChannel::PosZ, deltaRise);
+        precomputed_.addOffset(TrajectoryChannel::VelZ, deltaRise);
+    }
+
+    // 修补结果与重新生成的表只近似相等 (量化表尤其如此)，不写入缓存，避免冒充该参数下的原始表
+    return true;
+}
+
+void TrajectoryGenerator::setRobotParams(const RobotParams& robot)
+{
+    robotParams_ = robot;
+    ikModel_.setParameters(robot);
+}
+
+void TrajectoryGenerator::rebuildSpline()
+{
+    if (params_.type != TrajectoryType::Waypoint) {
+        spline_ = SplineTrajectory();
+        return;
+    }
+
+    // 未指定时刻时，路径点在duration内均匀分布
+    std::vector<float> times = params_.waypointTimes;
+    const size_t n = params_.waypoints.size();
+    if (times.size() != n && n >= 2) {
+        times.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            times[i] = params_.duration * static_cast<float>(i) / static_cast<float>(n - 1);
+        }
+    }
+    spline_.build(params_.waypoints, times, params_.splineKind);
+}
+
+void TrajectoryGenerator::rebuildPath()
+{
+    if (params_.type != TrajectoryType::Path) {
+        path_ = ArcLengthPath();
+        return;
+    }
+
+    const Vector3f center(params_.spiralX0, params_.spiralY0, params_.spiralZ0);
+    const float radius = params_.spiralAmplitude;
+    const float sweep = 2.0f * static_cast<float>(M_PI) * params_.pathTurns;
+    switch (params_.pathShape) {
+    case PathShape::Circle:
+        path_.build(ArcLengthPath::circle(center, radius), 0.0f, sweep);
+        break;
+    case PathShape::Line:
+        path_.build(ArcLengthPath::line(center, params_.pathEnd), 0.0f, 1.0f);
+        break;
+    case PathShape::Figure8:
+        path_.build(ArcLengthPath::figureEight(center, radius), 0.0f, sweep);
+        break;
+    case PathShape::Spiral:
+        path_.build(ArcLengthPath::spiral(center, radius, params_.pathTurns), 0.0f, 1.0f);
+        break;
+    }
+}
+
+float TrajectoryGenerator::tableDuration() const
+{
+    if (params_.type == TrajectoryType::Path) {
+        float s, speed, accel;
+        return pathMotion(0.0f, s, speed, accel);
+    }
+    return params_.duration;
+}
+
+float TrajectoryGenerator::pathMotion(float t, float& s, float& speed, float& accel) const
+{
+    s = speed = accel = 0.0f;
+    const float length = path_.length();
+    if (params_.pathSpeed <= 0.0f || length <= 0.0f) {
+        return 0.0f;
+    }
+
+    // 梯形速度曲线；路径太短达不到pathSpeed时退化为三角形
+    const float a = params_.pathAcceleration;
+    float peak = params_.pathSpeed;
+    float rampTime = a > 0.0f ? peak / a : 0.0f;
+    if (peak * rampTime > length) {
+        peak = std::sqrt(a * length);
+        rampTime = peak / a;
+    }
+    const float cruiseTime = (length - peak * rampTime) / peak;
+    const float duration = 2.0f * rampTime + cruiseTime;
+
+    if (t <= 0.0f) {
+        return duration;
+    }
+    if (t < rampTime) {
+        s = 0.5f * a * t * t;
+        speed = a * t;
+        accel = a;
+    } else if (t < rampTime + cruiseTime) {
+        s = 0.5f * peak * rampTime + peak * (t - rampTime);
+        speed = peak;
+    } else if (t < duration) {
+        const float left = duration - t;
+        s = length - 0.5f * a * left * left;
+        speed = a * left;
+        accel = -a;
+    } else {
+        s = length;
+    }
+    return duration;
+}
+
+TrajectorySpace TrajectoryGenerator::trajectorySpace() const
+{
+    if (externalSource_) {
+        return precomputed_.space();
+    }
+    switch (params_.type) {
+    case TrajectoryType::Sine:
+        return TrajectorySpace::Joint;
+    case TrajectoryType::Waypoint:
+        return params_.waypointSpace;
+    default:
+        return TrajectorySpace::Cartesian;
+    }
+}
+
+void TrajectoryGenerator::rebuildPrecomputed()
+{
+    rebuildSpline();
+    rebuildPath();
+
+    // 先查缓存：切回用过的配置或重启程序时无需重新计算
+    // 注意：笛卡尔表本身与机器人参数无关，机器人参数仅参与键计算，变化时不主动重建
+    uint64_t key = 0;
+    if (cache_) {
+        key = trajectoryConfigHash(robotParams_, params_, kPrecomputeDt);
+        if (cache_->lookup(key, precomputed_)) {
+            return;
+        }
+    }
+
+    // 直接写入SoA表，避免先生成AoS再转换
+    const size_t numPoints = static_cast<size_t>(std::lround(tableDuration() / kPrecomputeDt)) + 1;
+    precomputed_.resize(numPoints, kPrecomputeDt);
+    precomputed_.setSpace(trajectorySpace());
+    for (size_t i = 0; i < numPoints; ++i) {
+        precomputed_.setPoint(i, generatePoint(i * kPrecomputeDt));
+    }
+    precomputed_.encode(params_.storageEncoding);
+
+    if (cache_) {
+        cache_->insert(key, precomputed_);
+    }
+}
+
+bool TrajectoryGenerator::loadTrajectoryFile(const std::string& path, std::string* error)
+{
+    TrajectoryStore store;
+    if (!TrajectoryFile::map(path, store, nullptr, error)) {
+        return false;
+    }
+    setExternalTrajectory(store);
+    return true;
+}
+
+bool TrajectoryGenerator::saveTrajectoryFile(const std::string& path, const RobotParams& robot,
+                                             std::string* error) const
+{
+    const uint64_t hash = externalSource_ ? 0 : trajectoryConfigHash(robot, params_, kPrecomputeDt);
+    return TrajectoryFile::write(path, precomputed_, hash, error);
+}
+
+void TrajectoryGenerator::setExternalTrajectory(const TrajectoryStore& store)
+{
+    precomputed_ = store;
+    externalSource_ = true;
+}
+
+void TrajectoryGenerator::clearExternalTrajectory()
+{
+    if (!externalSource_) {
+        return;
+    }
+    externalSource_ = false;
+    rebuildPrecomputed();
+}
+
+bool TrajectoryGenerator::retimeTimeOptimal(const TimeOptimalParameterizer& topp,
+                                            TimeOptimalParameterizer::Result* result,
+                                            std::string* error)
+{
+    float t0 = 0.0f;
+    float t1 = tableDuration();
+    if (params_.type == TrajectoryType::Waypoint) {
+        if (spline_.empty()) {
+            if (error) {
+                *error = "路径点不足";
+            }
+            return false;
+        }
+        t0 = spline_.startTime();
+        t1 = spline_.endTime();
+    }
+
+    // 几何路径 q(s)：沿用参数化前的时间轴，只取其形状
+    const TimeOptimalParameterizer::JointPath path = [this, t0, t1](float s, Vector3f& q) {
+        const float t = t0 + s * (t1 - t0);
+        switch (params_.type) {
+        case TrajectoryType::Sine:
+            q = generateSineJointTrajectory(t);
+            return true;
+        case TrajectoryType::Waypoint:
+            if (params_.waypointSpace == TrajectorySpace::Joint) {
+                q = spline_.evaluate(t).position;
+                return true;
+            }
+            return ikModel_.inverseKinematics(spline_.evaluate(t).position, q);
+        case TrajectoryType::Path:
+            return ikModel_.inverseKinematics(path_.position(s * path_.length()), q);
+        default:
+            return ikModel_.inverseKinematics(generateSpiralPoint(t).position, q);
+        }
+    };
+
+    TrajectoryStore table;
+    if (!topp.parameterize(path, ikModel_, table, result, error)) {
+        return false;
+    }
+    setExternalTrajectory(table);
+    return true;
+}
+
 void TrajectoryGenerator::setTrajectoryType(TrajectoryType type)
 {
-    params_.type = type;
+    TrajectoryParams p = params_;
+    p.type = type;
+    setParameters(p);
 }
 
 TrajectoryPoint TrajectoryGenerator::generatePoint(float t) const
@@ -34,7 +351,15 @@ TrajectoryPoint TrajectoryGenerator::generatePoint(float t) const
         return generateSpiralPoint(t);
     case TrajectoryType::Sine:
         // 正弦轨迹在关节空间生成
-        return TrajectoryPoint();
+        return generateSinePoint(t);
+    case TrajectoryType::Waypoint:
+        return spline_.evaluate(t);
+    case TrajectoryType::Path: {
+        // 梯形速度：起止静止，中段恒速，终点后静止
+        float s, speed, accel;
+        pathMotion(t, s, speed, accel);
+        return path_.evaluate(s, speed, accel);
+    }
     default:
         return TrajectoryPoint();
     }
@@ -83,6 +408,23 @@ Eigen::Vector3f TrajectoryGenerator::generateSineJointTrajectory(float t) const
     return q;
 }
 
+TrajectoryPoint TrajectoryGenerator::generateSinePoint(float t) const
+{
+    TrajectoryPoint point;
+
+    const float omega = 2.0f * M_PI * params_.sineFrequency;
+    const float amp[3] = {params_.sineAmplitude1, params_.sineAmplitude2, -params_.sineAmplitude3};
+    const float phase[3] = {0.0f, static_cast<float>(M_PI / 4.0), static_cast<float>(M_PI / 2.0)};
+
+    for (int j = 0; j < 3; ++j) {
+        const float arg = omega * t + phase[j];
+        point.position[j] = amp[j] * std::sin(arg);
+        point.velocity[j] = amp[j] * omega * std::cos(arg);
+        point.acceleration[j] = -amp[j] * omega * omega * std::sin(arg);
+    }
+    return point;
+}
+
 std::vector<TrajectoryPoint> TrajectoryGenerator::generateTrajectory(float dt) const
 {
     std::vector<TrajectoryPoint> trajectory;
@@ -98,19 +440,19 @@ std::vector<TrajectoryPoint> TrajectoryGenerator::generateTrajectory(float dt) c
 
 bool TrajectoryGenerator::isTrajectoryFinished(float t) const
 {
-    return t >= params_.duration;
+    return t >= getDuration();
 }
 
 
 //ControlWorker 根据index查询预先计算的precomputedSpiralTrajectory_轨迹点
 TrajectoryPoint TrajectoryGenerator::getPrecomputedPoint(int index) const
 {
-    if (precomputedSpiralTrajectory_.empty()) {
+    if (precomputed_.empty()) {
         return TrajectoryPoint();
     }
     // 防止越界
     index = std::clamp(index, 0, 
-            static_cast<int>(precomputedSpiralTrajectory_.size()) - 1);
+            static_cast<int>(precomputed_.size()) - 1);
     
-    return precomputedSpiralTrajectory_[index];
+    return precomputed_.point(static_cast<size_t>(index));
 }
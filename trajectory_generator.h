@@ -1,8 +1,16 @@
 #ifndef TRAJECTORY_GENERATOR_H
 #define TRAJECTORY_GENERATOR_H
 
+#include "arc_length_path.h"
 #include "robot_common.h"
+#include "robot_model.h"
+#include "spline_trajectory.h"
+#include "time_optimal.h"
+#include "trajectory_store.h"
+
+class TrajectoryCache;
 #include <memory>
+#include <string>
 
 /**
  * @brief 轨迹生成器类 - 生成各种类型的工作空间轨迹
@@ -10,11 +18,32 @@
 class TrajectoryGenerator
 {
 public:
+    static constexpr float kPrecomputeDt = 0.001f;  // 预计算表时间步长 (秒)
+
+    /**
+     * @brief 参数依赖类别 (按位组合)，决定修改参数后如何更新预计算表
+     */
+    enum ParamDependency : uint32_t
+    {
+        DependsNone        = 0,
+        DependsShape       = 1u << 0,  // 形状/时长/类型变化，需重新生成
+        DependsTranslation = 1u << 1,  // 螺旋中心平移，O(n)平移即可
+        DependsZRise       = 1u << 2,  // Z上升速率，叠加线性斜坡
+        DependsEncoding    = 1u << 3   // 存储编码变化
+    };
+
+    /**
+     * @brief 计算从from到to的参数变化所涉及的依赖类别
+     */
+    static uint32_t parameterDependencies(const TrajectoryParams& from, const TrajectoryParams& to);
+
     /**
      * @brief 构造函数
      * @param params 轨迹参数
+     * @param cache 轨迹表缓存 (可为空，为空时每次都重新计算)
      */
-    explicit TrajectoryGenerator(const TrajectoryParams& params = TrajectoryParams());
+    explicit TrajectoryGenerator(const TrajectoryParams& params = TrajectoryParams(),
+                                 std::shared_ptr<TrajectoryCache> cache = nullptr);
 
     /**
      * @brief 设置轨迹参数
@@ -26,6 +55,16 @@ public:
      */
     const TrajectoryParams& getParameters() const { return params_; }
 
+    /**
+     * @brief 设置机器人参数 (参与缓存键计算)
+     */
+    void setRobotParams(const RobotParams& robot);
+
+    /**
+     * @brief 设置轨迹表缓存
+     */
+    void setCache(std::shared_ptr<TrajectoryCache> cache) { cache_ = std::move(cache); }
+
     /**
      * @brief 设置轨迹类型
      */
@@ -50,6 +89,18 @@ public:
      */
     TrajectoryPoint generateSpiralPoint(float t) const;
 
+    /**
+     * @brief 生成正弦轨迹点 (关节空间，含角速度和角加速度)
+     * @param t 时间 (秒)
+     * @return 关节空间轨迹点
+     */
+    TrajectoryPoint generateSinePoint(float t) const;
+
+    /**
+     * @brief 当前轨迹所在空间 (Sine为关节空间，Waypoint由waypointSpace决定)
+     */
+    TrajectorySpace trajectorySpace() const;
+
     /**
      * @brief 生成正弦轨迹点 (关节空间)
      * @param t 时间 (秒)
@@ -72,41 +123,139 @@ public:
     bool isTrajectoryFinished(float t) const;
 
     /**
-     * @brief 获取轨迹持续时间
+     * @brief 获取轨迹持续时间 (外部轨迹源时为其表长)
      */
-    float getDuration() const { return params_.duration; }
+    float getDuration() const
+    {
+        return externalSource_ || params_.type == TrajectoryType::Path ? precomputed_.duration() : params_.duration;
+    }
 
     /**
      * @brief 设置轨迹持续时间
      */
-    void setDuration(float duration) { params_.duration = duration; }
+    void setDuration(float duration) {
+        TrajectoryParams p = params_;
+        p.duration = duration;
+        setParameters(p);
+    }
 
     // 预计算的螺旋线轨迹查询接口
     TrajectoryPoint getPrecomputedPoint(int index) const;
 
+    /**
+     * @brief 按时间查询预计算轨迹 (三次Hermite插值，与控制周期无关)
+     * @param t 轨迹时间 (秒)
+     * @param timeScale 时间缩放 (速度倍率)，同一张表可服务不同速度
+     */
+    TrajectoryPoint sample(float t, float timeScale = 1.0f) const { return precomputed_.sample(t, timeScale); }
+
+    /**
+     * @brief 获取预计算轨迹表 (SoA，供批量消费者使用)
+     */
+    const TrajectoryStore& getPrecomputedTrajectory() const { return precomputed_; }
+
+    // ==================== 外部轨迹源 ====================
+
+    /**
+     * @brief 以mmap只读方式加载轨迹文件作为轨迹源 (示教记录、离线优化轨迹等)
+     * @param path 轨迹文件路径
+     * @param error 失败时的错误信息 (可为空)
+     * @return 是否成功
+     */
+    bool loadTrajectoryFile(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * @brief 将当前预计算表写入轨迹文件
+     * @param robot 用于计算配置哈希的机器人参数
+     */
+    bool saveTrajectoryFile(const std::string& path, const RobotParams& robot,
+                            std::string* error = nullptr) const;
+
+    /**
+     * @brief 使用外部轨迹表作为轨迹源，setParameters不再覆盖它
+     */
+    void setExternalTrajectory(const TrajectoryStore& store);
+
+    /**
+     * @brief 放弃外部轨迹源，按当前参数重新预计算
+     */
+    void clearExternalTrajectory();
+
+    bool hasExternalTrajectory() const { return externalSource_; }
+
+    /**
+     * @brief 对当前几何路径做时间最优参数化，结果作为外部轨迹源 (关节空间)
+     *
+     * 路径形状取自当前参数：螺旋线/笛卡尔路径点先逐点求逆解，
+     * duration和spiralRate只决定路径形状，实际时长由电机限幅决定。
+     * 调用clearExternalTrajectory()恢复按参数计时的轨迹。
+     * @param result 参数化结果 (可为空)
+     * @param error 失败时的错误信息 (可为空)
+     * @return 是否成功
+     */
+    bool retimeTimeOptimal(const TimeOptimalParameterizer& topp,
+                           TimeOptimalParameterizer::Result* result = nullptr,
+                           std::string* error = nullptr);
+
     // ==================== 螺旋线轨迹参数设置 ====================
 
-    void setSpiralAmplitude(float amplitude) { params_.spiralAmplitude = amplitude; }
-    void setSpiralRate(float rate) { params_.spiralRate = rate; }
+    // 以下设置均经过setParameters，保证预计算表同步更新
+
+    void setSpiralAmplitude(float amplitude) {
+        TrajectoryParams p = params_;
+        p.spiralAmplitude = amplitude;
+        setParameters(p);
+    }
+    void setSpiralRate(float rate) {
+        TrajectoryParams p = params_;
+        p.spiralRate = rate;
+        setParameters(p);
+    }
     void setSpiralCenter(float x0, float y0, float z0) {
-        params_.spiralX0 = x0;
-        params_.spiralY0 = y0;
-        params_.spiralZ0 = z0;
+        TrajectoryParams p = params_;
+        p.spiralX0 = x0;
+        p.spiralY0 = y0;
+        p.spiralZ0 = z0;
+        setParameters(p);
+    }
+    void setSpiralZRiseRate(float rate) {
+        TrajectoryParams p = params_;
+        p.spiralZRiseRate = rate;
+        setParameters(p);
     }
-    void setSpiralZRiseRate(float rate) { params_.spiralZRiseRate = rate; }
 
     // ==================== 正弦轨迹参数设置 ====================
 
     void setSineAmplitudes(float amp1, float amp2, float amp3) {
-        params_.sineAmplitude1 = amp1;
-        params_.sineAmplitude2 = amp2;
-        params_.sineAmplitude3 = amp3;
+        TrajectoryParams p = params_;
+        p.sineAmplitude1 = amp1;
+        p.sineAmplitude2 = amp2;
+        p.sineAmplitude3 = amp3;
+        setParameters(p);
+    }
+    void setSineFrequency(float freq) {
+        TrajectoryParams p = params_;
+        p.sineFrequency = freq;
+        setParameters(p);
     }
-    void setSineFrequency(float freq) { params_.sineFrequency = freq; }
 
 private:
+    void rebuildPrecomputed();
+    void rebuildSpline();
+    void rebuildPath();
+    float tableDuration() const;  // 预计算表时长 (Path类型由路径长度、速度和加速度决定)
+    float pathMotion(float t, float& s, float& speed, float& accel) const;  // Path类型t时刻的弧长/速度/切向加速度，返回总时长
+    bool patchPrecomputed(const TrajectoryParams& from, uint32_t deps);
+
     TrajectoryParams params_;
-    std::vector<TrajectoryPoint> precomputedSpiralTrajectory_;  // 预计算的螺旋线轨迹点序列
+    RobotParams robotParams_;
+    std::shared_ptr<TrajectoryCache> cache_;
+    SplineTrajectory spline_;      // 路径点样条 (Waypoint类型)
+    ArcLengthPath path_;           // 弧长参数化路径 (Path类型)
+    TrajectoryStore precomputed_;  // 预计算的螺旋线轨迹表 (SoA)
+    bool externalSource_ = false;  // precomputed_来自外部文件/调用者
+
+    RobotModel ikModel_;           // 时间最优参数化时对路径逐点求逆解
 };
 
 #endif // TRAJECTORY_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,426 @@
+#include "trajectory_store.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace {
+
+constexpr float kInt16Max = 32767.0f;
+
+// float -> IEEE754 half，就近舍入到偶数
+uint16_t floatToHalf(float value)
+{
+    uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t mant = x & 0x007fffffu;
+    const int32_t exp = static_cast<int32_t>((x >> 23) & 0xffu) - 127 + 15;
+
+    if ((x & 0x7fffffffu) >= 0x7f800000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (mant ? 0x200u : 0u));
+    }
+    if (exp >= 31) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (exp <= 0) {
+        // 半精度非规格化数
+        if (exp < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mant |= 0x00800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - exp);
+        uint32_t half = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+        if (rem > halfway || (rem == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u))) {
+        ++half;  // 进位可能进到指数，结果依然正确
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float halfToFloat(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    const uint32_t exp = (h >> 10) & 0x1fu;
+    const uint32_t mant = h & 0x3ffu;
+
+    if (exp == 0) {
+        const float f = std::ldexp(static_cast<float>(mant), -24);
+        return sign ? -f : f;
+    }
+
+    uint32_t x;
+    if (exp == 31) {
+        x = sign | 0x7f800000u | (mant << 13);
+    } else {
+        x = sign | ((exp + 112u) << 23) | (mant << 13);
+    }
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+size_t roundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+struct ChannelCoding
+{
+    float offset = 0.0f;
+    float scale = 1.0f;
+    float errorBound = 0.0f;
+};
+
+// 把一个通道的float值量化为int16/半精度，写入dst (count个16位元素)
+ChannelCoding quantizeChannel(const float* src, size_t count, TrajectoryEncoding encoding, uint8_t* dst)
+{
+    const auto range = std::minmax_element(src, src + count);
+    const float lo = *range.first;
+    const float hi = *range.second;
+
+    // 以区间中点为offset，半宽为归一化尺度
+    ChannelCoding coding;
+    coding.offset = 0.5f * (lo + hi);
+    const float halfRange = 0.5f * (hi - lo);
+    const float invHalfRange = halfRange > 0.0f ? 1.0f / halfRange : 0.0f;
+
+    // 浮点运算自身的舍入误差
+    const float arithmeticError = 4.0f * FLT_EPSILON * (std::abs(coding.offset) + halfRange);
+
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+    if (encoding == TrajectoryEncoding::Int16) {
+        coding.scale = halfRange / kInt16Max;
+        for (size_t i = 0; i < count; ++i) {
+            const float n = std::clamp((src[i] - coding.offset) * invHalfRange, -1.0f, 1.0f);
+            const int16_t q = static_cast<int16_t>(std::lround(n * kInt16Max));
+            std::memcpy(&out[i], &q, sizeof(q));
+        }
+        coding.errorBound = 0.5f * coding.scale + arithmeticError;
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            const float n = std::clamp((src[i] - coding.offset) * invHalfRange, -1.0f, 1.0f);
+            out[i] = floatToHalf(n);
+        }
+        // |n| <= 1 时半精度舍入误差不超过 2^-12，留一倍余量
+        coding.scale = halfRange;
+        coding.errorBound = std::ldexp(halfRange, -11) + arithmeticError;
+    }
+    return coding;
+}
+
+} // namespace
+
+TrajectoryStore TrajectoryStore::fromPoints(const std::vector<TrajectoryPoint>& points, float dt,
+                                            TrajectoryEncoding encoding)
+{
+    TrajectoryStore store;
+    store.resize(points.size(), dt);
+    for (size_t i = 0; i < points.size(); ++i) {
+        store.setPoint(i, points[i]);
+    }
+    store.encode(encoding);
+    return store;
+}
+
+size_t TrajectoryStore::elementSize(TrajectoryEncoding encoding)
+{
+    return encoding == TrajectoryEncoding::Float32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+size_t TrajectoryStore::channelStride() const
+{
+    return roundUp(count_ * elementSize(encoding_), kChannelAlignment);
+}
+
+void TrajectoryStore::allocate(size_t count, TrajectoryEncoding encoding)
+{
+    count_ = count;
+    encoding_ = encoding;
+    readOnly_ = false;
+    channels_.fill(nullptr);
+    storage_.reset();
+
+    const size_t stride = channelStride();
+    if (stride == 0) {
+        return;
+    }
+
+    uint8_t* block = static_cast<uint8_t*>(std::aligned_alloc(kChannelAlignment, stride * kChannelCount));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    storage_.reset(block, std::free);
+
+    for (int c = 0; c < kChannelCount; ++c) {
+        channels_[c] = block + c * stride;
+    }
+}
+
+void TrajectoryStore::resize(size_t count, float dt)
+{
+    dt_ = dt;
+    allocate(count, TrajectoryEncoding::Float32);
+    scale_.fill(1.0f);
+    offset_.fill(0.0f);
+    errorBound_.fill(0.0f);
+}
+
+void TrajectoryStore::attachExternal(std::shared_ptr<void> owner,
+                                     const std::array<const uint8_t*, kChannelCount>& channels,
+                                     size_t count, float dt, TrajectoryEncoding encoding,
+                                     const std::array<float, kChannelCount>& scale,
+                                     const std::array<float, kChannelCount>& offset,
+                                     const std::array<float, kChannelCount>& errorBound)
+{
+    storage_ = std::move(owner);
+    for (int c = 0; c < kChannelCount; ++c) {
+        // 只读映射，写接口由readOnly_拦截
+        channels_[c] = const_cast<uint8_t*>(channels[c]);
+    }
+    count_ = count;
+    dt_ = dt;
+    encoding_ = encoding;
+    scale_ = scale;
+    offset_ = offset;
+    errorBound_ = errorBound;
+    readOnly_ = true;
+}
+
+void TrajectoryStore::setPoint(size_t index, const TrajectoryPoint& point)
+{
+    if (readOnly_ || encoding_ != TrajectoryEncoding::Float32 || index >= count_) {
+        return;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        reinterpret_cast<float*>(channels_[axis])[index] = point.position[axis];
+        reinterpret_cast<float*>(channels_[3 + axis])[index] = point.velocity[axis];
+        reinterpret_cast<float*>(channels_[6 + axis])[index] = point.acceleration[axis];
+    }
+}
+
+void TrajectoryStore::detach()
+{
+    if (!readOnly_ && storage_.use_count() <= 1) {
+        return;
+    }
+
+    TrajectoryStore copy = *this;
+    allocate(copy.count_, copy.encoding_);
+    const size_t bytes = count_ * elementSize(encoding_);
+    for (int c = 0; c < kChannelCount; ++c) {
+        std::memcpy(channels_[c], copy.channels_[c], bytes);
+    }
+}
+
+void TrajectoryStore::addOffset(TrajectoryChannel channel, float delta)
+{
+    if (count_ == 0 || delta == 0.0f) {
+        return;
+    }
+
+    const int c = idx(channel);
+    if (encoding_ != TrajectoryEncoding::Float32) {
+        // 编码值相对offset存储，平移只改offset；元数据非共享，无需复制
+        offset_[c] += delta;
+        errorBound_[c] += 4.0f * FLT_EPSILON * std::abs(delta);
+        return;
+    }
+
+    detach();
+    float* data = reinterpret_cast<float*>(channels_[c]);
+    for (size_t i = 0; i < count_; ++i) {
+        data[i] += delta;
+    }
+}
+
+void TrajectoryStore::addRamp(TrajectoryChannel channel, float slope)
+{
+    if (count_ == 0 || slope == 0.0f) {
+        return;
+    }
+
+    detach();
+    const int c = idx(channel);
+    const float step = slope * dt_;
+    if (encoding_ == TrajectoryEncoding::Float32) {
+        float* data = reinterpret_cast<float*>(channels_[c]);
+        for (size_t i = 0; i < count_; ++i) {
+            data[i] += step * static_cast<float>(i);
+        }
+        return;
+    }
+
+    // 斜坡会改变取值范围，只对该通道解码、叠加后重新量化；
+    // 解码值已带有原误差，新误差上界 = 原上界 + 本次量化误差，多次修补时误差上界如实累加
+    std::vector<float> values(count_);
+    decodeChannel(channel, 0, count_, values.data());
+    for (size_t i = 0; i < count_; ++i) {
+        values[i] += step * static_cast<float>(i);
+    }
+    const ChannelCoding coding = quantizeChannel(values.data(), count_, encoding_, channels_[c]);
+    offset_[c] = coding.offset;
+    scale_[c] = coding.scale;
+    errorBound_[c] += coding.errorBound;
+}
+
+bool TrajectoryStore::encode(TrajectoryEncoding encoding)
+{
+    if (encoding_ != TrajectoryEncoding::Float32) {
+        return false;
+    }
+    if (encoding == TrajectoryEncoding::Float32 || count_ == 0) {
+        return true;
+    }
+
+    TrajectoryStore encoded;
+    encoded.dt_ = dt_;
+    encoded.space_ = space_;
+    encoded.allocate(count_, encoding);
+
+    for (int c = 0; c < kChannelCount; ++c) {
+        const ChannelCoding coding = quantizeChannel(reinterpret_cast<const float*>(channels_[c]), count_,
+                                                     encoding, encoded.channels_[c]);
+        encoded.offset_[c] = coding.offset;
+        encoded.scale_[c] = coding.scale;
+        encoded.errorBound_[c] = coding.errorBound;
+    }
+
+    *this = encoded;
+    return true;
+}
+
+float TrajectoryStore::value(TrajectoryChannel channel, size_t index) const
+{
+    const int c = idx(channel);
+
+    switch (encoding_) {
+    case TrajectoryEncoding::Float32:
+        return reinterpret_cast<const float*>(channels_[c])[index];
+    case TrajectoryEncoding::Int16: {
+        int16_t q;
+        std::memcpy(&q, channels_[c] + index * sizeof(int16_t), sizeof(q));
+        return offset_[c] + scale_[c] * static_cast<float>(q);
+    }
+    case TrajectoryEncoding::Float16:
+        return offset_[c] + scale_[c] * halfToFloat(reinterpret_cast<const uint16_t*>(channels_[c])[index]);
+    }
+    return 0.0f;
+}
+
+TrajectoryPoint TrajectoryStore::point(size_t index) const
+{
+    TrajectoryPoint p;
+    for (int axis = 0; axis < 3; ++axis) {
+        p.position[axis] = value(static_cast<TrajectoryChannel>(axis), index);
+        p.velocity[axis] = value(static_cast<TrajectoryChannel>(3 + axis), index);
+        p.acceleration[axis] = value(static_cast<TrajectoryChannel>(6 + axis), index);
+    }
+    return p;
+}
+
+TrajectoryPoint TrajectoryStore::sample(float t, float timeScale) const
+{
+    if (count_ == 0) {
+        return TrajectoryPoint();
+    }
+    if (count_ == 1 || !(t > 0.0f)) {
+        TrajectoryPoint p = point(0);
+        p.velocity *= timeScale;
+        p.acceleration *= timeScale * timeScale;
+        return p;
+    }
+
+    const float u = t / dt_;
+    const size_t last = count_ - 1;
+    size_t i = static_cast<size_t>(u);
+    float s = u - static_cast<float>(i);
+    if (i >= last) {
+        i = last - 1;
+        s = 1.0f;
+    }
+
+    // 三次Hermite基函数
+    const float s2 = s * s;
+    const float s3 = s2 * s;
+    const float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    const float h10 = s3 - 2.0f * s2 + s;
+    const float h01 = -2.0f * s3 + 3.0f * s2;
+    const float h11 = s3 - s2;
+
+    const TrajectoryPoint p0 = point(i);
+    const TrajectoryPoint p1 = point(i + 1);
+
+    TrajectoryPoint p;
+    p.position = h00 * p0.position + h10 * dt_ * p0.velocity
+               + h01 * p1.position + h11 * dt_ * p1.velocity;
+    p.velocity = h00 * p0.velocity + h10 * dt_ * p0.acceleration
+               + h01 * p1.velocity + h11 * dt_ * p1.acceleration;
+    p.acceleration = (1.0f - s) * p0.acceleration + s * p1.acceleration;
+
+    p.velocity *= timeScale;
+    p.acceleration *= timeScale * timeScale;
+    return p;
+}
+
+const float* TrajectoryStore::channelData(TrajectoryChannel channel) const
+{
+    if (encoding_ != TrajectoryEncoding::Float32) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float*>(channels_[idx(channel)]);
+}
+
+void TrajectoryStore::decodeChannel(TrajectoryChannel channel, size_t begin, size_t count, float* out) const
+{
+    if (begin >= count_) {
+        return;
+    }
+    count = std::min(count, count_ - begin);
+
+    const int c = idx(channel);
+    const float scale = scale_[c];
+    const float offset = offset_[c];
+
+    switch (encoding_) {
+    case TrajectoryEncoding::Float32:
+        std::memcpy(out, reinterpret_cast<const float*>(channels_[c]) + begin, count * sizeof(float));
+        break;
+    case TrajectoryEncoding::Int16: {
+        const int16_t* src = reinterpret_cast<const int16_t*>(channels_[c]) + begin;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = offset + scale * static_cast<float>(src[i]);
+        }
+        break;
+    }
+    case TrajectoryEncoding::Float16: {
+        const uint16_t* src = reinterpret_cast<const uint16_t*>(channels_[c]) + begin;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = offset + scale * halfToFloat(src[i]);
+        }
+        break;
+    }
+    }
+}
+
+float TrajectoryStore::positionErrorBound() const
+{
+    return std::max({errorBound_[idx(TrajectoryChannel::PosX)],
+                     errorBound_[idx(TrajectoryChannel::PosY)],
+                     errorBound_[idx(TrajectoryChannel::PosZ)]});
+}
@@ -0,0 +1,174 @@
+#ifndef TRAJECTORY_STORE_H
+#define TRAJECTORY_STORE_H
+
+#include "robot_common.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief 轨迹表通道 (SoA布局，每个分量一条连续数组)
+ */
+enum class TrajectoryChannel
+{
+    PosX, PosY, PosZ,
+    VelX, VelY, VelZ,
+    AccX, AccY, AccZ,
+    Count
+};
+
+/**
+ * @brief 结构数组(SoA)形式的紧凑轨迹表
+ *
+ * 每个通道单独一段64字节对齐的连续内存，批量消费者可直接拿到SIMD友好的数据流；
+ * 可选int16/float16编码，每通道独立scale/offset，并给出解码误差上界。
+ * 拷贝只共享底层缓冲区，不复制数据。
+ */
+class TrajectoryStore
+{
+public:
+    static constexpr int kChannelCount = static_cast<int>(TrajectoryChannel::Count);
+    static constexpr size_t kChannelAlignment = 64;
+
+    TrajectoryStore() = default;
+
+    /**
+     * @brief 由AoS轨迹点序列构建
+     * @param points 轨迹点序列
+     * @param dt 采样间隔 (秒)
+     * @param encoding 存储编码
+     */
+    static TrajectoryStore fromPoints(const std::vector<TrajectoryPoint>& points, float dt,
+                                      TrajectoryEncoding encoding = TrajectoryEncoding::Float32);
+
+    /**
+     * @brief 分配count个float32采样点 (内容未初始化)
+     */
+    void resize(size_t count, float dt);
+
+    /**
+     * @brief 写入一个采样点 (仅Float32编码)
+     */
+    void setPoint(size_t index, const TrajectoryPoint& point);
+
+    /**
+     * @brief 将Float32表压缩为指定编码
+     * @return false 如果当前不是Float32表
+     */
+    bool encode(TrajectoryEncoding encoding);
+
+    /**
+     * @brief 通道整体平移: value += delta
+     *
+     * Float32表原地O(n)相加；定点/半精度表只需调整offset，O(1)。
+     * 底层缓冲区被共享或只读时先复制一份 (写时复制)。
+     */
+    void addOffset(TrajectoryChannel channel, float delta);
+
+    /**
+     * @brief 通道叠加线性斜坡: value[i] += slope * i * dt
+     *
+     * 定点/半精度表只对该通道重新量化，误差上界在原上界上累加本次量化误差。
+     */
+    void addRamp(TrajectoryChannel channel, float slope);
+
+    /**
+     * @brief 挂接外部内存 (如mmap的文件)，不拷贝数据，表变为只读
+     * @param owner 外部内存的生命周期持有者
+     * @param channels 各通道数据起始地址
+     */
+    void attachExternal(std::shared_ptr<void> owner,
+                        const std::array<const uint8_t*, TrajectoryStore::kChannelCount>& channels,
+                        size_t count, float dt, TrajectoryEncoding encoding,
+                        const std::array<float, TrajectoryStore::kChannelCount>& scale,
+                        const std::array<float, TrajectoryStore::kChannelCount>& offset,
+                        const std::array<float, TrajectoryStore::kChannelCount>& errorBound);
+
+    /**
+     * @brief 通道原始字节 (任意编码)，长度为size()*elementSize(encoding())
+     */
+    const uint8_t* rawChannel(TrajectoryChannel channel) const { return channels_[idx(channel)]; }
+
+    bool isReadOnly() const { return readOnly_; }
+
+    TrajectorySpace space() const { return space_; }
+    void setSpace(TrajectorySpace space) { space_ = space; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    float dt() const { return dt_; }
+    float duration() const { return count_ > 0 ? (count_ - 1) * dt_ : 0.0f; }
+    TrajectoryEncoding encoding() const { return encoding_; }
+
+    /**
+     * @brief 所有通道占用的字节数
+     */
+    size_t byteSize() const { return channelStride() * kChannelCount; }
+
+    /**
+     * @brief 读取采样点 (index必须小于size())
+     */
+    TrajectoryPoint point(size_t index) const;
+
+    /**
+     * @brief 按时间查询，采样点之间做三次Hermite插值
+     *
+     * 位置由(位置, 速度)插值，速度由(速度, 加速度)插值，加速度线性插值。
+     * @param t 轨迹时间 (秒)，超出范围时钳位到端点
+     * @param timeScale 时间缩放因子 dτ/dt，速度乘以timeScale，加速度乘以timeScale²
+     */
+    TrajectoryPoint sample(float t, float timeScale = 1.0f) const;
+
+    /**
+     * @brief 读取单个通道的单个采样值
+     */
+    float value(TrajectoryChannel channel, size_t index) const;
+
+    /**
+     * @brief 通道原始float数组，仅Float32编码有效，否则返回nullptr
+     */
+    const float* channelData(TrajectoryChannel channel) const;
+
+    /**
+     * @brief 将通道[begin, begin+count)解码为float
+     */
+    void decodeChannel(TrajectoryChannel channel, size_t begin, size_t count, float* out) const;
+
+    float channelScale(TrajectoryChannel channel) const { return scale_[idx(channel)]; }
+    float channelOffset(TrajectoryChannel channel) const { return offset_[idx(channel)]; }
+
+    /**
+     * @brief 通道解码绝对误差上界 (Float32为0)
+     */
+    float errorBound(TrajectoryChannel channel) const { return errorBound_[idx(channel)]; }
+
+    /**
+     * @brief 三个位置通道的最大误差上界 (m)
+     */
+    float positionErrorBound() const;
+
+    /**
+     * @brief 每个采样值占用的字节数
+     */
+    static size_t elementSize(TrajectoryEncoding encoding);
+
+private:
+    static int idx(TrajectoryChannel channel) { return static_cast<int>(channel); }
+    size_t channelStride() const;
+    void allocate(size_t count, TrajectoryEncoding encoding);
+    void detach();
+
+    std::shared_ptr<void> storage_;
+    std::array<uint8_t*, kChannelCount> channels_{};
+    std::array<float, kChannelCount> scale_{};
+    std::array<float, kChannelCount> offset_{};
+    std::array<float, kChannelCount> errorBound_{};
+    size_t count_ = 0;
+    float dt_ = 0.0f;
+    TrajectoryEncoding encoding_ = TrajectoryEncoding::Float32;
+    TrajectorySpace space_ = TrajectorySpace::Cartesian;
+    bool readOnly_ = false;
+};
+
+#endif // TRAJECTORY_STORE_H
@@ -0,0 +1,327 @@
+#include "trajectory_validator.h"
+#include "time_optimal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+namespace {
+
+constexpr size_t kMinChunk = 4096;  // 每线程最少采样点数，更小的表不值得开线程
+
+/**
+ * @brief 把[0, count)均分给threads个线程执行，最后一块在调用线程上执行
+ */
+void parallelFor(int threads, size_t count, const std::function<void(int, size_t, size_t)>& body)
+{
+    std::vector<std::thread> workers;
+    workers.reserve(threads > 1 ? threads - 1 : 0);
+    const size_t chunk = (count + threads - 1) / threads;
+    for (int w = 0; w < threads; ++w) {
+        const size_t begin = std::min(count, w * chunk);
+        const size_t end = std::min(count, begin + chunk);
+        if (w + 1 < threads) {
+            workers.emplace_back(body, w, begin, end);
+        } else {
+            body(w, begin, end);
+        }
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+int violationIndex(TrajectoryValidator::Violation violation)
+{
+    int i = 0;
+    for (uint32_t v = violation; v > 1; v >>= 1) {
+        ++i;
+    }
+    return i;
+}
+
+/**
+ * @brief 单个线程块的检查结果
+ */
+struct ChunkResult
+{
+    TrajectoryValidator::Report report;
+    size_t reported = 0;
+};
+
+} // namespace
+
+TrajectoryValidator::Options::Options()
+    : limits(TimeOptimalParameterizer::motorLimits(damiao::DM4310, damiao::DM4310, damiao::DM4310))
+{
+}
+
+TrajectoryValidator::TrajectoryValidator(const Options& options)
+    : options_(options)
+{
+}
+
+float TrajectoryValidator::conditioning(const Vector3f& q, float a2, float a3)
+{
+    const float scale = a2 * a3 * (a2 + a3);
+    if (!(scale > 0.0f)) {
+        return 0.0f;
+    }
+    const float reach = a2 * std::cos(q[1]) + a3 * std::cos(q[1] + q[2]);
+    return std::abs(a2 * a3 * std::sin(q[2]) * reach) / scale;
+}
+
+TrajectoryValidator::Report TrajectoryValidator::validate(const TrajectoryStore& table, const RobotModel& model) const
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    Report report;
+    report.blockingMask = options_.blockingMask;
+    const size_t n = table.size();
+    report.samples = n;
+    if (n == 0) {
+        return report;
+    }
+
+    int threads = options_.threads > 0 ? options_.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::clamp(threads, 1, static_cast<int>(std::max<size_t>(1, n / kMinChunk)));
+
+    const bool jointSpace = table.space() == TrajectorySpace::Joint;
+    const float dt = table.dt() > 0.0f ? table.dt() : 1e-3f;
+
+    // 1. 关节轨迹 (SoA)：关节表直接解码，笛卡尔表并行逆解
+    std::array<std::vector<float>, 3> q;
+    std::array<std::vector<float>, 3> qd;
+    std::array<std::vector<float>, 3> qdd;
+    for (int j = 0; j < 3; ++j) {
+        q[j].resize(n);
+        if (jointSpace) {
+            qd[j].resize(n);
+            qdd[j].resize(n);
+        }
+    }
+    std::vector<uint8_t> valid(n, 1);
+
+    parallelFor(threads, n, [&](int, size_t begin, size_t end) {
+        if (begin >= end) {
+            return;
+        }
+        const size_t count = end - begin;
+        if (jointSpace) {
+            for (int j = 0; j < 3; ++j) {
+                table.decodeChannel(static_cast<TrajectoryChannel>(static_cast<int>(TrajectoryChannel::PosX) + j),
+                                    begin, count, q[j].data() + begin);
+                table.decodeChannel(static_cast<TrajectoryChannel>(static_cast<int>(TrajectoryChannel::VelX) + j),
+                                    begin, count, qd[j].data() + begin);
+                table.decodeChannel(static_cast<TrajectoryChannel>(static_cast<int>(TrajectoryChannel::AccX) + j),
+                                    begin, count, qdd[j].data() + begin);
+            }
+            return;
+        }
+
+        std::array<std::vector<float>, 3> position;
+        for (int j = 0; j < 3; ++j) {
+            position[j].resize(count);
+            table.decodeChannel(static_cast<TrajectoryChannel>(static_cast<int>(TrajectoryChannel::PosX) + j),
+                                begin, count, position[j].data());
+        }
+        Vector3f solution = Vector3f::Zero();
+        for (size_t k = 0; k < count; ++k) {
+            const Vector3f p(position[0][k], position[1][k], position[2][k]);
+            const bool ok = model.inverseKinematics(p, solution) && solution.allFinite();
+            valid[begin + k] = ok ? 1 : 0;
+            for (int j = 0; j < 3; ++j) {
+                q[j][begin + k] = ok ? solution[j] : 0.0f;
+            }
+        }
+    });
+
+    // 2. 逐点检查：各线程写自己的结果块，最后合并
+    const float a2 = model.getParameters().dh[1].a;
+    const float a3 = model.getParameters().dh[2].a;
+    const size_t maxReported = static_cast<size_t>(std::max(options_.maxReported, 0));
+    std::vector<ChunkResult> results(threads);
+
+    parallelFor(threads, n, [&](int worker, size_t begin, size_t end) {
+        ChunkResult& chunk = results[worker];
+        Report& r = chunk.report;
+        std::vector<float> state(9, 0.0f);
+
+        auto record = [&](size_t k, Violation violation, int joint, float value, float limit) {
+            r.violations |= violation;
+            ++r.counts[violationIndex(violation)];
+            if (chunk.reported < maxReported) {
+                Finding f;
+                f.index = k;
+                f.time = k * dt;
+                f.violation = violation;
+                f.joint = joint;
+                f.value = value;
+                f.limit = limit;
+                r.firstFindings.push_back(f);
+                ++chunk.reported;
+            }
+        };
+
+        for (size_t k = begin; k < end; ++k) {
+            const std::array<size_t, kViolationKinds> countsBefore = r.counts;
+
+            if (!valid[k]) {
+                record(k, ViolationIk, -1, 0.0f, 0.0f);
+                ++r.offendingSamples;
+                continue;
+            }
+
+            const Vector3f qk(q[0][k], q[1][k], q[2][k]);
+            Vector3f velocity;
+            Vector3f acceleration;
+            if (jointSpace) {
+                velocity = Vector3f(qd[0][k], qd[1][k], qd[2][k]);
+                acceleration = Vector3f(qdd[0][k], qdd[1][k], qdd[2][k]);
+            } else {
+                // 相邻有效采样差分：两侧都有效取中心差分，否则单侧
+                const bool hasPrev = k > 0 && valid[k - 1];
+                const bool hasNext = k + 1 < n && valid[k + 1];
+                const size_t lo = hasPrev ? k - 1 : k;
+                const size_t hi = hasNext ? k + 1 : k;
+                const float span = static_cast<float>(hi - lo) * dt;
+                for (int j = 0; j < 3; ++j) {
+                    velocity[j] = span > 0.0f ? (q[j][hi] - q[j][lo]) / span : 0.0f;
+                    acceleration[j] = hasPrev && hasNext ? (q[j][hi] - 2.0f * q[j][k] + q[j][lo]) / (dt * dt) : 0.0f;
+                }
+            }
+
+            // 分支跳变：与上一有效采样相比任一关节突跳
+            if (k > 0 && valid[k - 1]) {
+                for (int j = 0; j < 3; ++j) {
+                    const float step = std::abs(qk[j] - q[j][k - 1]);
+                    if (step > options_.maxJointStep) {
+                        record(k, ViolationBranchFlip, j, step, options_.maxJointStep);
+                        break;
+                    }
+                }
+            }
+
+            for (int j = 0; j < 3; ++j) {
+                const float limit = options_.limits[j].Q_MAX * options_.limitScale;
+                if (std::abs(qk[j]) > limit) {
+                    record(k, ViolationPosition, j, qk[j], limit);
+                    break;
+                }
+            }
+
+            for (int j = 0; j < 3; ++j) {
+                const float speed = std::abs(velocity[j]);
+                r.peakVelocity[j] = std::max(r.peakVelocity[j], speed);
+                const float limit = options_.limits[j].DQ_MAX * options_.limitScale;
+                if (speed > limit) {
+                    record(k, ViolationVelocity, j, velocity[j], limit);
+                    break;
+                }
+            }
+
+            for (int j = 0; j < 3; ++j) {
+                state[j] = qk[j];
+                state[3 + j] = velocity[j];
+                state[6 + j] = acceleration[j];
+            }
+            const Vector3f tau = model.computeTorqueDecoupled(state);
+            for (int j = 0; j < 3; ++j) {
+                const float magnitude = std::abs(tau[j]);
+                r.peakTorque[j] = std::max(r.peakTorque[j], magnitude);
+                const float limit = options_.limits[j].TAU_MAX * options_.limitScale;
+                if (magnitude > limit) {
+                    record(k, ViolationTorque, j, tau[j], limit);
+                    break;
+                }
+            }
+
+            const float cond = conditioning(qk, a2, a3);
+            r.minConditioning = std::min(r.minConditioning, cond);
+            if (cond < options_.minConditioning) {
+                record(k, ViolationSingular, -1, cond, options_.minConditioning);
+            }
+
+            if (r.counts != countsBefore) {
+                ++r.offendingSamples;
+            }
+        }
+    });
+
+    // 3. 合并：块按序号排列，违例列表天然有序，截取最早的若干条
+    for (const ChunkResult& chunk : results) {
+        const Report& r = chunk.report;
+        report.offendingSamples += r.offendingSamples;
+        report.violations |= r.violations;
+        for (int i = 0; i < kViolationKinds; ++i) {
+            report.counts[i] += r.counts[i];
+        }
+        report.peakVelocity = report.peakVelocity.cwiseMax(r.peakVelocity);
+        report.peakTorque = report.peakTorque.cwiseMax(r.peakTorque);
+        report.minConditioning = std::min(report.minConditioning, r.minConditioning);
+        for (const Finding& f : r.firstFindings) {
+            if (report.firstFindings.size() >= maxReported) {
+                break;
+            }
+            report.firstFindings.push_back(f);
+        }
+    }
+
+    report.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return report;
+}
+
+const char* TrajectoryValidator::violationName(Violation violation)
+{
+    switch (violation) {
+    case ViolationIk:
+        return "逆解失败";
+    case ViolationPosition:
+        return "位置超限";
+    case ViolationVelocity:
+        return "速度超限";
+    case ViolationTorque:
+        return "力矩超限";
+    case ViolationSingular:
+        return "接近奇异";
+    case ViolationBranchFlip:
+        return "分支跳变";
+    default:
+        return "无";
+    }
+}
+
+std::string TrajectoryValidator::Report::summary() const
+{
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "轨迹预检%s: %zu点, 违例%zu点, 峰值速度(%.2f, %.2f, %.2f)rad/s, "
+                  "峰值力矩(%.2f, %.2f, %.2f)N·m, 最小条件%.3f, 耗时%.2fms",
+                  ok() ? "通过" : "未通过", samples, offendingSamples,
+                  peakVelocity[0], peakVelocity[1], peakVelocity[2],
+                  peakTorque[0], peakTorque[1], peakTorque[2], minConditioning, elapsedMs);
+    std::string text = line;
+
+    for (int i = 0; i < kViolationKinds; ++i) {
+        if (counts[i] > 0) {
+            std::snprintf(line, sizeof(line), "\n  %s: %zu点", violationName(static_cast<Violation>(1u << i)), counts[i]);
+            text += line;
+        }
+    }
+    for (const Finding& f : firstFindings) {
+        if (f.joint >= 0) {
+            std::snprintf(line, sizeof(line), "\n  t=%.3fs #%zu %s 关节%d: %.3f (限制%.3f)",
+                          f.time, f.index, violationName(f.violation), f.joint + 1, f.value, f.limit);
+        } else if (f.violation == ViolationSingular) {
+            std::snprintf(line, sizeof(line), "\n  t=%.3fs #%zu %s: %.4f (下限%.4f)",
+                          f.time, f.index, violationName(f.violation), f.value, f.limit);
+        } else {
+            std::snprintf(line, sizeof(line), "\n  t=%.3fs #%zu %s", f.time, f.index, violationName(f.violation));
+        }
+        text += line;
+    }
+    return text;
+}